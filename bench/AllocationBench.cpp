@@ -0,0 +1,203 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  AllocationBench
+  Heap allocations per message on send and receive paths after warm-up. Global operator new is replaced
+  by counting one: "caller" columns count allocations made by Board calls in the thread of user (payloads
+  are built before the call), "all threads" also counts service threads of connector.
+  Every message is echoed by in-memory connector and received before the next one is sent, as in steady
+  flow. The echo thread builds a new parcel from raw bytes (one allocation for std::string payload), as
+  receiver of a real connector does. If port is given, Send() through UartBoardConnector is measured too: port must echo what it receives.
+    AllocationBench [messages_count = 20000] [payload_size = 64] [port]
+*/
+
+#include <new>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "BoardConnect.h"
+#include "FakeBoardConnector.h"
+
+struct BenchPacket{
+  std::uint8_t id;
+  std::uint32_t counter;
+  double value;
+};
+
+BOARD_CONNECT_MESSAGE( BenchPacket,
+                       board_connect::codec::Field<&BenchPacket::id>,
+                       board_connect::codec::Field<&BenchPacket::counter>,
+                       board_connect::codec::Field<&BenchPacket::value> );
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Counting operator new
+    --------------------------------------------------------------------------------------------------------------------
+*/
+namespace {
+std::atomic<std::uint64_t> all_threads_allocations{0};
+thread_local std::uint64_t thread_allocations = 0;
+
+void* CountedAllocate(std::size_t size) noexcept {
+  ++thread_allocations;
+  all_threads_allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+}
+
+void* operator new(std::size_t size) {
+  void* block = CountedAllocate(size);
+  if(block == nullptr)
+    throw std::bad_alloc();
+  return block;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { std::free(block); }
+
+
+using namespace board_connect;
+
+
+  //adds allocations made by this thread during its lifetime to total
+class CountScope{
+  std::uint64_t& total_;
+  const std::uint64_t start_;
+public:
+  explicit CountScope(std::uint64_t& total) : total_(total), start_(thread_allocations) {}
+  ~CountScope() { total_ += thread_allocations - start_; }
+};
+
+
+struct AllocationReport{
+  std::uint64_t send_caller = 0;
+  std::uint64_t receive_caller = 0;
+  std::uint64_t all_threads = 0;
+  std::size_t messages = 0;
+};
+
+
+  //send(i) sends message i, then it's received back. The first warm_up messages are not counted
+template <typename DataType, typename SendOperation>
+AllocationReport Measure(Board<DataType>& board, std::size_t count, std::size_t warm_up, SendOperation&& send) {
+  AllocationReport report;
+  std::uint64_t all_threads_start = 0;
+  for(std::size_t i = 0; i < warm_up + count; ++i) {
+    const bool counted = i >= warm_up;
+    if(i == warm_up) {
+      all_threads_start = all_threads_allocations.load();
+    }
+    std::uint64_t send_allocations = 0;
+    std::uint64_t receive_allocations = 0;
+    bool sent;
+    {
+      CountScope scope(send_allocations);
+      sent = send(i);
+    }
+    const auto deadline = Clock_t::now() + std::chrono::seconds(1);
+    while(sent && Clock_t::now() < deadline) {
+      {
+        CountScope scope(receive_allocations);
+        if(board.Receive())
+          break;
+      }
+      std::this_thread::yield();
+    }
+    if(counted) {
+      report.send_caller += send_allocations;
+      report.receive_caller += receive_allocations;
+      report.messages += sent ? 1 : 0;
+    }
+  }
+  report.all_threads = all_threads_allocations.load() - all_threads_start;
+  return report;
+}
+
+
+void PrintRow(const char* name, const AllocationReport& report) {
+  const double messages = static_cast<double>(std::max<std::size_t>(report.messages, 1));
+  std::printf("%-34s %14.3f %17.3f %13.3f\n", name, static_cast<double>(report.send_caller) / messages,
+              static_cast<double>(report.receive_caller) / messages, static_cast<double>(report.all_threads) / messages);
+}
+
+
+int main(int argc, char* argv[]) {
+  const std::size_t messages_count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20000;
+  const std::size_t payload_size = argc > 2 ? std::max(1, std::atoi(argv[2])) : 64;
+  const std::string port = argc > 3 ? argv[3] : "";
+  const std::size_t warm_up = 1000;
+  cout.setstate(std::ios::failbit);
+
+  test::FakeConnectionSettings settings;
+  settings.idle_period = std::chrono::microseconds(1);
+  test::FakeBoardConnectorFactory<std::string> factory;
+  Board<std::string> board(settings, factory);
+  if(!(board.Connect() == ConnectionStatus_t::CONNECTED_OK))
+    return 1;
+
+    //payloads are built before measurement: their allocation is the cost of user code
+  std::vector<std::string> payloads;
+  auto make_payloads = [&payloads, messages_count, warm_up, payload_size]{
+    payloads.assign(warm_up + messages_count, std::string(payload_size, 'x'));
+  };
+
+  std::printf("%zu messages, payload %zu bytes; allocations per message\n", messages_count, payload_size);
+  std::printf("%-34s %14s %17s %13s\n", "", "send, caller", "receive, caller", "all threads");
+
+  make_payloads();
+  PrintRow("Send(std::string&&)", Measure(board, messages_count, warm_up, [&](std::size_t i){
+    return board.Send(std::move(payloads[i]));
+  }));
+
+  make_payloads();
+  PrintRow("Send(const std::string&)", Measure(board, messages_count, warm_up, [&](std::size_t i){
+    return board.Send(payloads[i]);
+  }));
+
+  PrintRow("Emplace(size, char)", Measure(board, messages_count, warm_up, [&](std::size_t){
+    return board.Emplace(payload_size, 'x');
+  }));
+
+  const SharedParcel<std::string> shared = MakeParcel<std::string>(payload_size, 'x');
+  PrintRow("SendShared(one parcel)", Measure(board, messages_count, warm_up, [&](std::size_t){
+    return board.SendShared(shared);
+  }));
+  board.Disconnect();
+
+  test::FakeBoardConnectorFactory<BenchPacket> packet_factory;
+  Board<BenchPacket> packet_board(settings, packet_factory);
+  packet_board.Connect();
+  PrintRow("Send(codec message)", Measure(packet_board, messages_count, warm_up, [&](std::size_t i){
+    return packet_board.Send(BenchPacket{ 1, static_cast<std::uint32_t>(i), 0.5 });
+  }));
+  packet_board.Disconnect();
+
+#ifdef BOARD_CONNECT_WINAPI
+  if(!port.empty()) {
+    uart::UartConnectionSettings uart_settings(port, 115200);
+    uart_settings.low_latency = true;
+    Board<std::string> uart_board(uart_settings, uart::UartBoardConnectorFactory<std::string>());
+    if(!(uart_board.Connect() == ConnectionStatus_t::CONNECTED_OK)) {
+      std::printf("Unable to connect to %s\n", port.c_str());
+      return 1;
+    }
+      //echo may arrive in several chunks, only Send() column is meaningful here
+    make_payloads();
+    PrintRow("UART Send(std::string&&)", Measure(uart_board, messages_count, warm_up, [&](std::size_t i){
+      return uart_board.Send(std::move(payloads[i]));
+    }));
+    uart_board.Disconnect();
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  BringUpBench
+  Time of BoardGroup::ConnectAll() for a rack of boards, whose connection takes connect_delay each
+  (in-memory connectors imitating device opening), for several max_parallel values. The last run has
+  one hanging board and shows that ConnectAll() returns by timeout.
+    BringUpBench [boards_count = 64] [connect_delay_ms = 50]
+*/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "BoardConnect.h"
+#include "FakeBoardConnector.h"
+
+using namespace board_connect;
+
+
+void DisconnectAll(BoardGroup<std::string>& group) {
+  for(std::size_t i = 0; i < group.Size(); ++i) {
+    group[i]->Disconnect();
+  }
+}
+
+
+int main(int argc, char* argv[]) {
+  const std::size_t boards_count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 64;
+  const std::chrono::milliseconds connect_delay(argc > 2 ? std::max(0, std::atoi(argv[2])) : 50);
+  cout.setstate(std::ios::failbit);
+
+  test::FakeConnectionSettings settings;
+  settings.connect_delay = connect_delay;
+  test::FakeBoardConnectorFactory<std::string> factory;
+  BoardGroup<std::string> group;
+  for(std::size_t i = 0; i < boards_count; ++i) {
+    group.Add(settings, factory, "board " + std::to_string(i));
+  }
+
+  std::printf("%zu boards, %lld ms to connect each\n", boards_count, static_cast<long long>(connect_delay.count()));
+  std::printf("%13s %12s %10s %10s\n", "max_parallel", "elapsed, ms", "connected", "timed out");
+  for(std::size_t max_parallel : { std::size_t(1), std::size_t(8), std::size_t(16), boards_count }) {
+    const ConnectAllReport report = group.ConnectAll(max_parallel, std::chrono::minutes(1));
+    std::printf("%13zu %12lld %10zu %10s\n", max_parallel, static_cast<long long>(report.elapsed.count()), report.connected_count, "-");
+    DisconnectAll(group);
+  }
+
+    //one board hangs: bring-up is limited by timeout of 4 connection delays
+  const std::chrono::milliseconds timeout = std::max(connect_delay * 4, std::chrono::milliseconds(100));
+  test::FakeConnectionSettings hanging_settings;
+  hanging_settings.connect_delay = timeout * 5;
+  group.Add(hanging_settings, factory, "hanging");
+  const ConnectAllReport report = group.ConnectAll(boards_count, timeout);
+  std::size_t timed_out_count = 0;
+  for(const auto& result : report.boards) {
+    timed_out_count += result.timed_out ? 1 : 0;
+  }
+  std::printf("%13zu %12lld %10zu %10zu   (+1 hanging board, timeout %lld ms)\n", boards_count, static_cast<long long>(report.elapsed.count()),
+              report.connected_count, timed_out_count, static_cast<long long>(timeout.count()));
+
+  group.Remove("hanging");      //waits for the hanging attempt: Disconnect() of the board is serialized with Connect()
+  DisconnectAll(group);
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  CodecBench
+  Messages per second of MessageCodec Pack / Unpack against hand-written memcpy and byte swap code for
+  the same 19-byte message, and of StreamDecoder::Feed for plain and framed messages.
+    CodecBench [messages_count = 10000000] [chunk_size = 4096]
+*/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "BoardConnect.h"
+
+struct BenchPacket{
+  std::uint8_t id;
+  std::int16_t value;
+  std::uint32_t counter;
+  float gain;
+  double time;
+};
+
+BOARD_CONNECT_MESSAGE( BenchPacket,
+                       board_connect::codec::Field<&BenchPacket::id>,
+                       board_connect::codec::Field<&BenchPacket::value, board_connect::codec::Endian_t::BIG>,
+                       board_connect::codec::Field<&BenchPacket::counter>,
+                       board_connect::codec::Field<&BenchPacket::gain>,
+                       board_connect::codec::Field<&BenchPacket::time, board_connect::codec::Endian_t::BIG> );
+
+  //the same fields with sync word and CRC-8
+struct FramedBenchPacket{
+  std::uint8_t id;
+  std::int16_t value;
+  std::uint32_t counter;
+  float gain;
+  double time;
+};
+
+BOARD_CONNECT_FRAMED_MESSAGE( FramedBenchPacket, 0x55AA,
+                              board_connect::codec::Field<&FramedBenchPacket::id>,
+                              board_connect::codec::Field<&FramedBenchPacket::value, board_connect::codec::Endian_t::BIG>,
+                              board_connect::codec::Field<&FramedBenchPacket::counter>,
+                              board_connect::codec::Field<&FramedBenchPacket::gain>,
+                              board_connect::codec::Field<&FramedBenchPacket::time, board_connect::codec::Endian_t::BIG> );
+
+using namespace board_connect;
+
+constexpr std::size_t PACKET_SIZE = codec::MessageCodec<BenchPacket>::SIZE;
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Hand-written equivalent of codec for BenchPacket (little-endian host)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void PackByHand(const BenchPacket& packet, char* out) {
+  out[0] = static_cast<char>(packet.id);
+  std::uint16_t value;
+  std::memcpy(&value, &packet.value, 2);
+  value = static_cast<std::uint16_t>((value << 8) | (value >> 8));
+  std::memcpy(out + 1, &value, 2);
+  std::memcpy(out + 3, &packet.counter, 4);
+  std::memcpy(out + 7, &packet.gain, 4);
+  std::uint64_t time;
+  std::memcpy(&time, &packet.time, 8);
+  time = codec::ByteSwap(time);
+  std::memcpy(out + 11, &time, 8);
+}
+
+BenchPacket UnpackByHand(const char* in) {
+  BenchPacket packet{};
+  packet.id = static_cast<std::uint8_t>(in[0]);
+  std::uint16_t value;
+  std::memcpy(&value, in + 1, 2);
+  value = static_cast<std::uint16_t>((value << 8) | (value >> 8));
+  std::memcpy(&packet.value, &value, 2);
+  std::memcpy(&packet.counter, in + 3, 4);
+  std::memcpy(&packet.gain, in + 7, 4);
+  std::uint64_t time;
+  std::memcpy(&time, in + 11, 8);
+  time = codec::ByteSwap(time);
+  std::memcpy(&packet.time, &time, 8);
+  return packet;
+}
+
+
+  //messages are packed into / unpacked from ring of 64 KB, so the data stays in cache as in a receive loop
+constexpr std::size_t RING_MESSAGES = 65536 / PACKET_SIZE;
+
+template <typename Pack>
+double PackPerSecond(std::size_t count, Pack&& pack, std::uint64_t& sink) {
+  std::vector<char> ring(RING_MESSAGES * PACKET_SIZE);
+  BenchPacket packet{ 1, -2, 0, 0.5f, 1.0 };
+  const auto start = Clock_t::now();
+  for(std::size_t i = 0; i < count; ++i) {
+    packet.counter = static_cast<std::uint32_t>(i);
+    pack(packet, ring.data() + (i % RING_MESSAGES) * PACKET_SIZE);
+  }
+  const double elapsed_s = std::chrono::duration<double>(Clock_t::now() - start).count();
+  sink += static_cast<unsigned char>(ring[count % RING_MESSAGES * PACKET_SIZE + 3]);
+  return static_cast<double>(count) / elapsed_s;
+}
+
+template <typename Unpack>
+double UnpackPerSecond(std::size_t count, Unpack&& unpack, std::uint64_t& sink) {
+  std::vector<char> ring(RING_MESSAGES * PACKET_SIZE);
+  for(std::size_t i = 0; i < RING_MESSAGES; ++i) {
+    PackByHand(BenchPacket{ 1, -2, static_cast<std::uint32_t>(i), 0.5f, 1.0 }, ring.data() + i * PACKET_SIZE);
+  }
+  std::uint64_t sum = 0;
+  const auto start = Clock_t::now();
+  for(std::size_t i = 0; i < count; ++i) {
+    const BenchPacket packet = unpack(ring.data() + (i % RING_MESSAGES) * PACKET_SIZE);
+    sum += packet.counter + static_cast<std::uint64_t>(packet.value) + static_cast<std::uint64_t>(packet.time);
+  }
+  const double elapsed_s = std::chrono::duration<double>(Clock_t::now() - start).count();
+  sink += sum;
+  return static_cast<double>(count) / elapsed_s;
+}
+
+
+  //stream of count messages fed by chunks. Returns messages/s
+template <typename DataType>
+double FeedPerSecond(std::size_t count, std::size_t chunk_size, std::uint64_t& sink) {
+  std::vector<char> stream;
+  std::vector<char> scratch;
+  for(std::size_t i = 0; i < count; ++i) {
+    DataType packet{};
+    packet.counter = static_cast<std::uint32_t>(i);
+    const std::string_view raw = codec::ToRaw(packet, scratch);
+    stream.insert(stream.end(), raw.begin(), raw.end());
+  }
+  codec::StreamDecoder<DataType> decoder;
+  std::uint64_t sum = 0;
+  const auto start = Clock_t::now();
+  for(std::size_t pos = 0; pos < stream.size(); pos += chunk_size) {
+    decoder.Feed(stream.data() + pos, std::min(chunk_size, stream.size() - pos), [&sum](DataType&& packet){
+      sum += packet.counter;
+    });
+  }
+  const double elapsed_s = std::chrono::duration<double>(Clock_t::now() - start).count();
+  sink += sum;
+  return static_cast<double>(count) / elapsed_s;
+}
+
+
+void PrintRow(const char* name, double per_second) {
+  std::printf("%-28s %14.1f %10.2f\n", name, per_second / 1e6, 1e9 / per_second);
+}
+
+
+int main(int argc, char* argv[]) {
+  const std::size_t messages_count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10000000;
+  const std::size_t chunk_size = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4096;
+  cout.setstate(std::ios::failbit);
+
+  std::uint64_t sink = 0;
+  std::printf("%zu messages of %zu bytes\n", messages_count, PACKET_SIZE);
+  std::printf("%-28s %14s %10s\n", "", "Mmessages/s", "ns/message");
+  PrintRow("Pack, codec", PackPerSecond(messages_count, [](const BenchPacket& packet, char* out){
+    codec::MessageCodec<BenchPacket>::Pack(packet, out);
+  }, sink));
+  PrintRow("Pack, memcpy by hand", PackPerSecond(messages_count, PackByHand, sink));
+  PrintRow("Unpack, codec", UnpackPerSecond(messages_count, codec::MessageCodec<BenchPacket>::Unpack, sink));
+  PrintRow("Unpack, memcpy by hand", UnpackPerSecond(messages_count, UnpackByHand, sink));
+
+    //stream of plain messages is kept in memory, limit its size
+  const std::size_t feed_count = std::min<std::size_t>(messages_count, 2000000);
+  PrintRow("Feed, plain messages", FeedPerSecond<BenchPacket>(feed_count, chunk_size, sink));
+  PrintRow("Feed, framed messages", FeedPerSecond<FramedBenchPacket>(feed_count, chunk_size, sink));
+
+  std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink));
+  return 0;
+}
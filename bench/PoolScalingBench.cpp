@@ -0,0 +1,97 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  PoolScalingBench
+  Throughput of DecodePipeline on WorkStealingPool of 1..hardware_concurrency threads.
+  Each frame is decoded by a CPU-bound loop of about work_us microseconds; frames are submitted by one thread
+  and received in order by another, as FeederLoop and user thread do. Speedup is relative to 1 thread.
+    PoolScalingBench [frames_count = 20000] [work_us = 20] [max_threads = hardware_concurrency]
+*/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+
+
+  //calibrated busy loop: result depends on every byte, so it is not optimized out
+unsigned long long Decode(const std::string& frame, unsigned rounds) {
+  unsigned long long hash = 1469598103934665603ull;
+  for(unsigned round = 0; round < rounds; ++round) {
+    for(unsigned char byte : frame) {
+      hash = (hash ^ byte) * 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+
+unsigned CalibrateRounds(const std::string& frame, unsigned work_us) {
+  constexpr unsigned PROBE_ROUNDS = 2000;
+  volatile unsigned long long sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  sink = sink + Decode(frame, PROBE_ROUNDS);
+  const double probe_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  const double rounds = PROBE_ROUNDS * work_us / (probe_us > 0 ? probe_us : 1);
+  return rounds < 1 ? 1 : static_cast<unsigned>(rounds);
+}
+
+
+double FramesPerSecond(std::size_t threads_count, int frames_count, const std::string& frame, unsigned rounds) {
+  WorkStealingPool pool(threads_count);
+  DecodePipeline<unsigned long long, std::string> pipeline([rounds](const std::string& raw){ return Decode(raw, rounds); }, pool);
+
+  const auto start = std::chrono::steady_clock::now();
+  std::thread submitter([&pipeline, &frame, frames_count]{
+    for(int i = 0; i < frames_count; ++i) {
+      pipeline.Submit(frame);
+    }
+  });
+  int received = 0;
+  while(received < frames_count) {
+    if(pipeline.Receive()) {
+      ++received;
+    }
+    else {
+      std::this_thread::yield();
+    }
+  }
+  const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  submitter.join();
+  return frames_count / elapsed_s;
+}
+
+
+int main(int argc, char* argv[]) {
+  const int frames_count = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const unsigned work_us = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 20;
+  cout.setstate(std::ios::failbit);
+
+  const std::string frame(64, 'x');
+  const unsigned rounds = CalibrateRounds(frame, work_us);
+  const std::size_t max_threads = argc > 3 ? std::max(1, std::atoi(argv[3])) : std::max(1u, std::thread::hardware_concurrency());
+
+  std::printf("frames %d, decode ~%u us per frame\n", frames_count, work_us);
+  std::printf("%8s %14s %9s %11s\n", "threads", "frames/s", "speedup", "efficiency");
+  std::vector<std::size_t> threads_counts;
+  for(std::size_t threads = 1; threads < max_threads; threads *= 2) {
+    threads_counts.push_back(threads);
+  }
+  threads_counts.push_back(max_threads);
+
+  double single_thread = 0;
+  for(std::size_t threads : threads_counts) {
+    const double rate = FramesPerSecond(threads, frames_count, frame, rounds);
+    if(threads == 1)
+      single_thread = rate;
+    std::printf("%8zu %14.0f %9.2f %10.0f%%\n", threads, rate, rate / single_thread, 100 * rate / single_thread / threads);
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  SampleDecoderBench
+  Samples per second of SampleFrameDecoder: conversion kernels alone and Feed() of whole frames
+  (conversion, de-interleaving into per-channel rings, Consume() by reader) for int16 / int24 frames.
+  The same source is built as SampleDecoderBenchScalar with BOARD_CONNECT_NO_SIMD to compare with scalar kernels.
+    SampleDecoderBench [megabytes = 64] [chunk_size = 4096]
+*/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+
+
+const char* FormatName(SampleFormat_t format) {
+  return format == SampleFormat_t::INT16_LE ? "int16" : "int24";
+}
+
+
+std::string MakeStream(std::size_t size) {
+  std::string stream(size, '\0');
+  unsigned state = 12345;
+  for(auto& byte : stream) {
+    state = state * 1103515245u + 12345u;
+    byte = static_cast<char>(state >> 16);
+  }
+  return stream;
+}
+
+
+double KernelSamplesPerSecond(SampleFormat_t format, const std::string& stream) {
+  const std::size_t sample_size = static_cast<std::size_t>(format);
+  const std::size_t count = stream.size() / sample_size;
+  std::vector<float> dst(count);
+  const auto src = reinterpret_cast<const unsigned char*>(stream.data());
+
+  const auto start = std::chrono::steady_clock::now();
+  if(format == SampleFormat_t::INT16_LE) {
+    kernels::Int16ToFloat(src, dst.data(), count, 1.0f / 32768);
+  }
+  else {
+    kernels::Int24ToFloat(src, dst.data(), count, 1.0f / 8388608);
+  }
+  const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  volatile float sink = dst[count / 2];
+  (void)sink;
+  return count / elapsed_s;
+}
+
+
+double DecoderSamplesPerSecond(SampleFormat_t format, std::size_t channels_count, const std::string& stream, std::size_t chunk_size) {
+  SampleFrameDecoder decoder(channels_count, format, 8192);
+  std::vector<float> channel(8192);
+
+  const auto start = std::chrono::steady_clock::now();
+  for(std::size_t position = 0; position < stream.size(); position += chunk_size) {
+    decoder.Feed(stream.data() + position, std::min(chunk_size, stream.size() - position));
+    const std::size_t available = decoder.Available();
+    decoder.Read(0, channel.data(), available);
+    decoder.Consume(available);
+  }
+  const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return stream.size() / static_cast<std::size_t>(format) / elapsed_s;
+}
+
+
+int main(int argc, char* argv[]) {
+  const std::size_t megabytes = argc > 1 ? std::max(1, std::atoi(argv[1])) : 64;
+  const std::size_t chunk_size = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4096;
+  cout.setstate(std::ios::failbit);
+
+  const std::string stream = MakeStream(megabytes << 20);
+#ifdef BOARD_CONNECT_SSE2
+  std::printf("kernels: SSE2\n");
+#else
+  std::printf("kernels: scalar\n");
+#endif
+  std::printf("%6s %9s %18s\n", "format", "channels", "Msamples/s");
+  for(SampleFormat_t format : { SampleFormat_t::INT16_LE, SampleFormat_t::INT24_LE }) {
+    std::printf("%6s %9s %18.1f\n", FormatName(format), "kernel", KernelSamplesPerSecond(format, stream) / 1e6);
+    for(std::size_t channels_count : { 1, 2, 4, 8, 32 }) {
+      std::printf("%6s %9zu %18.1f\n", FormatName(format), channels_count,
+                  DecoderSamplesPerSecond(format, channels_count, stream, chunk_size) / 1e6);
+    }
+  }
+  return 0;
+}
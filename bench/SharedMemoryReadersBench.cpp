@@ -0,0 +1,112 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  SharedMemoryReadersBench
+  One publisher writes messages into shared memory ring, 1..8 readers (threads with their own
+  SharedMemoryReader) read them. Publisher never waits for readers: a reader, which falls behind by more
+  than slot_count messages, loses the overwritten ones. Rate 0 - publisher writes as fast as it can.
+    SharedMemoryReadersBench [messages_count = 200000] [message_size = 64] [slot_count = 1024] [rate_per_s = 0]
+*/
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+using namespace board_connect::shared_memory;
+
+
+struct ReaderResult{
+  std::uint64_t received = 0;
+  std::uint64_t lost = 0;
+  double mean_latency_us = 0;
+};
+
+
+void ReaderLoop(const std::string& name, std::atomic<std::size_t>& ready, const std::atomic_bool& published, ReaderResult& result) {
+  SharedMemoryReader reader;
+  const bool opened = reader.Open(name);
+  ready.fetch_add(1);
+  if(!opened)
+    return;
+
+  std::vector<char> message;
+  TimePoint_t timestamp;
+  double latency_sum_us = 0;
+  while(true) {
+    if(reader.Read(message, timestamp)) {
+      ++result.received;
+      latency_sum_us += std::chrono::duration<double, std::micro>(Clock_t::now() - timestamp).count();
+      continue;
+    }
+    if(published.load())
+      break;        //publisher has finished and everything left is read
+    std::this_thread::yield();
+  }
+  result.lost = reader.LostCount();
+  result.mean_latency_us = result.received == 0 ? 0 : latency_sum_us / static_cast<double>(result.received);
+}
+
+
+int main(int argc, char* argv[]) {
+  const std::size_t messages_count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200000;
+  const std::size_t message_size = argc > 2 ? std::max(1, std::atoi(argv[2])) : 64;
+  const std::uint32_t slot_count = argc > 3 ? static_cast<std::uint32_t>(std::max(1, std::atoi(argv[3]))) : 1024;
+  const double rate_per_s = argc > 4 ? std::max(0.0, std::atof(argv[4])) : 0;
+  cout.setstate(std::ios::failbit);
+
+  std::printf("%zu messages of %zu bytes, %u slots, %s\n", messages_count, message_size, slot_count,
+              rate_per_s > 0 ? (std::to_string(static_cast<long long>(rate_per_s)) + " messages/s").c_str() : "unpaced");
+  std::printf("%8s %16s %16s %12s %18s\n", "readers", "published/s", "received/reader", "lost/reader", "mean latency, us");
+
+  const std::vector<char> message(message_size, 'x');
+  for(std::size_t readers_count = 1; readers_count <= 8; ++readers_count) {
+    const std::string name = "BoardConnectBench_Readers_" + std::to_string(readers_count);
+    SharedMemoryPublisher publisher(name, slot_count, static_cast<std::uint32_t>(message_size));
+
+    std::atomic<std::size_t> ready{0};
+    std::atomic_bool published{false};
+    std::vector<ReaderResult> results(readers_count);
+    std::vector<std::thread> readers;
+    for(std::size_t i = 0; i < readers_count; ++i) {
+      readers.emplace_back(ReaderLoop, std::cref(name), std::ref(ready), std::cref(published), std::ref(results[i]));
+    }
+    while(ready.load() < readers_count) {
+      std::this_thread::yield();
+    }
+
+    const auto start = Clock_t::now();
+    for(std::size_t i = 0; i < messages_count; ++i) {
+      if(rate_per_s > 0) {
+        const auto due = start + std::chrono::duration_cast<Clock_t::duration>(std::chrono::duration<double>(i / rate_per_s));
+        while(Clock_t::now() < due) {
+          std::this_thread::yield();
+        }
+      }
+      publisher.Publish(message.data(), message.size());
+    }
+    const double elapsed_s = std::chrono::duration<double>(Clock_t::now() - start).count();
+    published.store(true);
+    for(auto& reader : readers) {
+      reader.join();
+    }
+
+    double received = 0, lost = 0, latency_us = 0;
+    for(const auto& result : results) {
+      received += static_cast<double>(result.received);
+      lost += static_cast<double>(result.lost);
+      latency_us += result.mean_latency_us;
+    }
+    const double readers_d = static_cast<double>(readers_count);
+    std::printf("%8zu %16.0f %16.0f %12.0f %18.2f\n", readers_count, static_cast<double>(messages_count) / elapsed_s,
+                received / readers_d, lost / readers_d, latency_us / readers_d);
+  }
+  return 0;
+}
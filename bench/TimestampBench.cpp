@@ -0,0 +1,68 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  TimestampBench
+  Cost of time tagging of received data: reading of monotonic clock, receive queue of timestamped parcels
+  compared with queue of bare parcels, ClockCorrelator updates and conversions. Nanoseconds per operation.
+    TimestampBench [iterations = 1000000]
+*/
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+
+
+template <typename Routine>
+double NanosecondsPerCall(long iterations, Routine routine) {
+  const auto start = Clock_t::now();
+  for(long i = 0; i < iterations; ++i) {
+    routine(i);
+  }
+  return std::chrono::duration<double, std::nano>(Clock_t::now() - start).count() / iterations;
+}
+
+
+int main(int argc, char* argv[]) {
+  const long iterations = argc > 1 ? std::max(1L, std::atol(argv[1])) : 1000000L;
+  cout.setstate(std::ios::failbit);
+
+  volatile long long sink = 0;
+  std::printf("%-44s %10s\n", "operation", "ns");
+
+  std::printf("%-44s %10.1f\n", "Clock_t::now()", NanosecondsPerCall(iterations, [&sink](long){
+    sink = sink + Clock_t::now().time_since_epoch().count();
+  }));
+
+    //receive path: receiver thread stores parcel, user thread takes it. Payload is moved back and forth
+  std::string payload(64, 'p');
+  Buffer<std::string> bare_queue;
+  std::printf("%-44s %10.1f\n", "Store + Take, bare parcel", NanosecondsPerCall(iterations, [&](long){
+    bare_queue.Store(std::move(payload));
+    payload = std::move(*bare_queue.Take());
+  }));
+
+  Buffer<TimestampedParcel<std::string>> tagged_queue;
+  std::printf("%-44s %10.1f\n", "Clock_t::now() + Store + Take, tagged parcel", NanosecondsPerCall(iterations, [&](long){
+    tagged_queue.Store({ std::move(payload), Clock_t::now() });
+    auto parcel = tagged_queue.Take();
+    sink = sink + parcel->timestamp.time_since_epoch().count();
+    payload = std::move(parcel->data);
+  }));
+
+    //board clock runs at 1 MHz, 1000 ppm faster than host
+  ClockCorrelator correlator(1.0e6L, 256);
+  const TimePoint_t origin = Clock_t::now();
+  std::printf("%-44s %10.1f\n", "ClockCorrelator::AddSample, window 256", NanosecondsPerCall(iterations, [&](long i){
+    correlator.AddSample(static_cast<long long>(i * 1001), origin + std::chrono::milliseconds(i));
+  }));
+  std::printf("%-44s %10.1f\n", "ClockCorrelator::ToHostTime", NanosecondsPerCall(iterations, [&](long i){
+    sink = sink + correlator.ToHostTime(i)->time_since_epoch().count();
+  }));
+  return 0;
+}
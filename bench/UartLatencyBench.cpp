@@ -0,0 +1,97 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  UartLatencyBench
+  Round-trip time of small parcels through a real serial port with low_latency mode off and on.
+  Port must echo everything it receives: TX-RX jumper on the adapter or a board running echo firmware.
+  Latency timer of FTDI adapter is set on connection in low latency mode, see ApplyFtdiLatencyTimer().
+    UartLatencyBench [port = COM1] [baud = 115200] [parcels = 200] [parcel_size = 16]
+*/
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+
+
+struct LatencyReport{
+  std::vector<double> round_trips_us;
+  int lost = 0;
+};
+
+
+LatencyReport MeasureRoundTrips(const uart::UartConnectionSettings& settings, int parcels_count, std::size_t parcel_size) {
+  LatencyReport report;
+  Board<std::string> board(settings, uart::UartBoardConnectorFactory<std::string>());
+  if(!(board.Connect() == ConnectionStatus_t::CONNECTED_OK)) {
+    report.lost = parcels_count;
+    return report;
+  }
+
+  const std::string parcel(parcel_size, 'U');
+  for(int i = 0; i < parcels_count; ++i) {
+    const auto start = Clock_t::now();
+    const auto deadline = start + std::chrono::seconds(1);
+    board.Send(parcel);
+
+    std::size_t received = 0;     //echo may come in several chunks
+    while(received < parcel_size && Clock_t::now() < deadline) {
+      auto chunk = board.Receive();
+      if(chunk) {
+        received += chunk->size();
+      }
+      else {
+        std::this_thread::yield();
+      }
+    }
+    if(received < parcel_size) {
+      ++report.lost;
+      continue;
+    }
+    report.round_trips_us.push_back(std::chrono::duration<double, std::micro>(Clock_t::now() - start).count());
+  }
+  board.Disconnect();
+  return report;
+}
+
+
+void PrintReport(const char* mode, LatencyReport& report) {
+  auto& rtt = report.round_trips_us;
+  if(rtt.empty()) {
+    std::printf("%12s %10s %10s %10s %6d\n", mode, "-", "-", "-", report.lost);
+    return;
+  }
+  std::sort(rtt.begin(), rtt.end());
+  const double median = rtt[rtt.size() / 2];
+  const double p99 = rtt[std::min(rtt.size() - 1, rtt.size() * 99 / 100)];
+  std::printf("%12s %10.0f %10.0f %10.0f %6d\n", mode, median, p99, rtt.back(), report.lost);
+}
+
+
+int main(int argc, char* argv[]) {
+  const std::string port = argc > 1 ? argv[1] : "COM1";
+  const uart::BaudRate_t baud = argc > 2 ? std::atoll(argv[2]) : 115200;
+  const int parcels_count = argc > 3 ? std::max(1, std::atoi(argv[3])) : 200;
+  const std::size_t parcel_size = argc > 4 ? std::max(1, std::atoi(argv[4])) : 16;
+  cout.setstate(std::ios::failbit);       //printf output only
+
+  std::printf("%s, %lld baud, %d parcels of %zu bytes, round trip in us\n", port.c_str(), baud, parcels_count, parcel_size);
+  std::printf("%12s %10s %10s %10s %6s\n", "low_latency", "median", "p99", "max", "lost");
+  for(bool low_latency : { false, true }) {
+    uart::UartConnectionSettings settings(port, baud);
+    settings.low_latency = low_latency;
+    settings.receive_loop_period = uart::Duration_t(low_latency ? 50 : 200);
+    settings.purge_on_connect = true;       //echo of previous run must not be counted
+
+    LatencyReport report = MeasureRoundTrips(settings, parcels_count, parcel_size);
+    PrintReport(low_latency ? "on" : "off", report);
+  }
+  return 0;
+}
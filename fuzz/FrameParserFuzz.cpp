@@ -0,0 +1,49 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Fuzz target for reliable::FrameParser::Feed
+  Input: first byte - chunk size, the rest - byte stream. Stream is fed in chunks, then a valid frame
+  is fed after it: parser must resynchronize and deliver this frame whatever garbage was before.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  if(size == 0)
+    return 0;
+  constexpr std::size_t MAX_PAYLOAD_SIZE = 256;
+  const std::size_t chunk_size = data[0] + 1;
+  const char* stream = reinterpret_cast<const char*>(data + 1);
+  const std::size_t stream_size = size - 1;
+
+  reliable::FrameParser parser(MAX_PAYLOAD_SIZE);
+  auto check_frame = [](reliable::Frame&& frame){
+    if(frame.payload.size() > MAX_PAYLOAD_SIZE || frame.type < reliable::FRAME_DATA || frame.type > reliable::FRAME_RESET)
+      std::abort();
+  };
+  for(std::size_t pos = 0; pos < stream_size; pos += chunk_size) {
+    parser.Feed(stream + pos, std::min(chunk_size, stream_size - pos), check_frame);
+  }
+
+    //garbage may hide the start of the next frame only up to the maximal frame size
+  const std::string payload(stream, std::min(stream_size, MAX_PAYLOAD_SIZE));
+  const std::string frame = reliable::EncodeFrame(reliable::FRAME_DATA, 7, 0x1234, payload);
+  const std::string padding(reliable::FRAME_HEADER_SIZE + MAX_PAYLOAD_SIZE + reliable::FRAME_CRC_SIZE, '\0');
+  bool delivered = false;
+  parser.Feed(padding.data(), padding.size(), check_frame);
+  parser.Feed(frame.data(), frame.size(), [&](reliable::Frame&& parsed){
+    check_frame(std::move(parsed));
+    delivered |= (parsed.epoch == 7 && parsed.seq == 0x1234 && parsed.payload == payload);
+  });
+  if(!delivered)
+    std::abort();
+  return 0;
+}
@@ -0,0 +1,59 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Fuzz target for FixedSizeFramer and DelimiterFramer
+  Input: frame size, chunk size, maximal frame size, delimiter, the rest - byte stream. Stream is fed in chunks,
+  frames must be the same as frames cut from the whole stream at once.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "BoardConnect.h"
+
+using namespace board_connect;
+
+
+template <typename Framer>
+std::vector<std::string> FeedByChunks(Framer& framer, const std::string& stream, std::size_t chunk_size) {
+  std::vector<std::string> frames;
+  for(std::size_t pos = 0; pos < stream.size(); pos += chunk_size) {
+    framer(stream.substr(pos, chunk_size), [&frames](std::string frame){ frames.push_back(std::move(frame)); });
+  }
+  return frames;
+}
+
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  if(size < 4)
+    return 0;
+  const std::size_t frame_size = data[0] % 64 + 1;
+  const std::size_t chunk_size = data[1] + 1;
+  const std::size_t max_frame_size = data[2] % 32 + 1;
+  const char delimiter = static_cast<char>(data[3] % 4);       //small alphabet of delimiters makes frequent frames
+  const std::string stream(reinterpret_cast<const char*>(data + 4), size - 4);
+
+  FixedSizeFramer fixed_framer(frame_size);
+  const std::vector<std::string> fixed_frames = FeedByChunks(fixed_framer, stream, chunk_size);
+  if(fixed_frames.size() != stream.size() / frame_size)
+    std::abort();
+  for(std::size_t i = 0; i < fixed_frames.size(); ++i) {
+    if(fixed_frames[i] != stream.substr(i * frame_size, frame_size))
+      std::abort();
+  }
+
+    //terminated, non-empty segments not longer than max_frame_size
+  std::vector<std::string> expected;
+  for(std::size_t begin = 0, end; (end = stream.find(delimiter, begin)) != std::string::npos; begin = end + 1) {
+    if(end > begin && end - begin <= max_frame_size)
+      expected.push_back(stream.substr(begin, end - begin));
+  }
+  DelimiterFramer delimiter_framer(delimiter, max_frame_size);
+  if(FeedByChunks(delimiter_framer, stream, chunk_size) != expected)
+    std::abort();
+  return 0;
+}
@@ -0,0 +1,46 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Standalone driver for fuzz targets, used when the targets are not built with libFuzzer.
+  Replays files given as arguments (e.g. crash reproducers), then runs random inputs.
+  Usage: <target> [iterations] [file...]
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <iostream>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+
+
+int main(int argc, char* argv[]) {
+  std::cout.setstate(std::ios::failbit);
+  const long iterations = argc > 1 ? std::atol(argv[1]) : 10000;
+
+  for(int i = 2; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    const std::vector<char> input{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+  }
+
+    //inputs of random size, mostly made of few distinct bytes, so that sync bytes and small lengths are frequent
+  std::mt19937 random_engine(12345);
+  std::vector<std::uint8_t> input;
+  for(long i = 0; i < iterations; ++i) {
+    input.resize(random_engine() % 2048);
+    const unsigned alphabet = (i % 2) ? 256 : 4;
+    for(auto& byte : input) {
+      const unsigned value = random_engine() % alphabet;
+      byte = static_cast<std::uint8_t>(alphabet == 256 ? value : (value == 0 ? 0xA5 : value));
+    }
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  std::cerr<<"fuzz driver: "<<iterations<<" random inputs passed"<<std::endl;
+  return 0;
+}
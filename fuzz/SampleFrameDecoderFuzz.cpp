@@ -0,0 +1,46 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Fuzz target for SampleFrameDecoder::Feed
+  Input: byte 0 - channels count, byte 1 - format and capacity, byte 2 - chunk size, the rest - byte stream.
+  Channels must stay in lockstep and never exceed capacity whatever is fed.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "BoardConnect.h"
+#include "SampleFrameDecoder.h"
+
+using namespace board_connect;
+
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  if(size < 3)
+    return 0;
+  const std::size_t channels_count = data[0] % 16 + 1;
+  const SampleFormat_t format = (data[1] & 1) ? SampleFormat_t::INT24_LE : SampleFormat_t::INT16_LE;
+  const std::size_t capacity = (data[1] >> 1) + 1;
+  const std::size_t chunk_size = data[2] + 1;
+  const char* stream = reinterpret_cast<const char*>(data + 3);
+  const std::size_t stream_size = size - 3;
+
+  SampleFrameDecoder decoder(channels_count, format, capacity);
+  std::vector<float> samples(capacity);
+  for(std::size_t pos = 0; pos < stream_size; pos += chunk_size) {
+    decoder.Feed(stream + pos, std::min(chunk_size, stream_size - pos));
+    const std::size_t available = decoder.Available();
+    if(available > capacity)
+      std::abort();
+    for(std::size_t channel = 0; channel < channels_count; ++channel) {
+      if(decoder.Read(channel, samples.data(), samples.size()) != available)
+        std::abort();
+    }
+    if(pos % 3 == 0)
+      decoder.Consume(available / 2);
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Fuzz target for codec::StreamDecoder::Feed
+  Input: first byte - chunk size, the rest - byte stream. Stream is decoded into codec messages
+  chunk by chunk and at once: results must be the same. Then it's decoded as std::string.
+  At last the stream is taken as noise before two framed messages: decoder must skip it and find
+  the second message at least (the first one may be overlapped by false frame starting in noise).
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "BoardConnect.h"
+
+struct FuzzMessage{
+  std::uint8_t id;
+  std::int16_t value;
+  std::uint32_t counter;
+  float gain;
+  double time;
+};
+
+BOARD_CONNECT_MESSAGE( FuzzMessage,
+                       board_connect::codec::Field<&FuzzMessage::id>,
+                       board_connect::codec::Field<&FuzzMessage::value, board_connect::codec::Endian_t::BIG>,
+                       board_connect::codec::Field<&FuzzMessage::counter>,
+                       board_connect::codec::Field<&FuzzMessage::gain>,
+                       board_connect::codec::Field<&FuzzMessage::time, board_connect::codec::Endian_t::BIG> );
+
+struct FramedFuzzMessage{
+  std::uint8_t id;
+  std::uint32_t counter;
+};
+
+BOARD_CONNECT_FRAMED_MESSAGE( FramedFuzzMessage, 0x55AA,
+                              board_connect::codec::Field<&FramedFuzzMessage::id>,
+                              board_connect::codec::Field<&FramedFuzzMessage::counter> );
+
+using namespace board_connect;
+
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+  if(size == 0)
+    return 0;
+  const std::size_t chunk_size = data[0] + 1;
+  const char* stream = reinterpret_cast<const char*>(data + 1);
+  const std::size_t stream_size = size - 1;
+
+  std::vector<std::vector<char>> by_chunks;
+  std::vector<std::vector<char>> at_once;
+  std::vector<char> scratch;
+  auto collect = [&scratch](std::vector<std::vector<char>>& target){
+    return [&scratch, &target](FuzzMessage&& message){
+      const std::string_view raw = codec::ToRaw(message, scratch);
+      target.emplace_back(raw.begin(), raw.end());
+    };
+  };
+
+  codec::StreamDecoder<FuzzMessage> chunked_decoder;
+  for(std::size_t pos = 0; pos < stream_size; pos += chunk_size) {
+    chunked_decoder.Feed(stream + pos, std::min(chunk_size, stream_size - pos), collect(by_chunks));
+  }
+  codec::StreamDecoder<FuzzMessage> decoder;
+  decoder.Feed(stream, stream_size, collect(at_once));
+
+  if(by_chunks != at_once || at_once.size() != stream_size / codec::MessageCodec<FuzzMessage>::SIZE)
+    std::abort();
+    //packing of unpacked message gives the same bytes
+  for(std::size_t i = 0; i < at_once.size(); ++i) {
+    if(!std::equal(at_once[i].begin(), at_once[i].end(), stream + i * codec::MessageCodec<FuzzMessage>::SIZE)) {
+        //NaN payloads of float / double may be canonicalized, compare only messages without them
+      auto message = codec::FromRaw<FuzzMessage>(stream + i * codec::MessageCodec<FuzzMessage>::SIZE, codec::MessageCodec<FuzzMessage>::SIZE);
+      if(message && message->gain == message->gain && message->time == message->time)
+        std::abort();
+    }
+  }
+
+  std::size_t string_bytes = 0;
+  codec::StreamDecoder<std::string> string_decoder;
+  for(std::size_t pos = 0; pos < stream_size; pos += chunk_size) {
+    string_decoder.Feed(stream + pos, std::min(chunk_size, stream_size - pos), [&string_bytes](std::string&& chunk){
+      string_bytes += chunk.size();
+    });
+  }
+  if(string_bytes != stream_size)
+    std::abort();
+
+    //payload bytes are neither 0xAA nor 0x55, so no false frame starts inside real ones
+  std::vector<char> framed_stream(stream, stream + stream_size);
+  for(const FramedFuzzMessage& message : { FramedFuzzMessage{ 1, 0x01020304 }, FramedFuzzMessage{ 2, 0x11121314 } }) {
+    const std::string_view raw = codec::ToRaw(message, scratch);
+    framed_stream.insert(framed_stream.end(), raw.begin(), raw.end());
+  }
+  std::vector<std::uint32_t> framed_by_chunks;
+  std::vector<std::uint32_t> framed_at_once;
+  codec::StreamDecoder<FramedFuzzMessage> framed_chunked_decoder;
+  for(std::size_t pos = 0; pos < framed_stream.size(); pos += chunk_size) {
+    framed_chunked_decoder.Feed(framed_stream.data() + pos, std::min(chunk_size, framed_stream.size() - pos),
+                                [&framed_by_chunks](FramedFuzzMessage&& message){ framed_by_chunks.push_back(message.counter); });
+  }
+  codec::StreamDecoder<FramedFuzzMessage> framed_decoder;
+  framed_decoder.Feed(framed_stream.data(), framed_stream.size(),
+                      [&framed_at_once](FramedFuzzMessage&& message){ framed_at_once.push_back(message.counter); });
+  if(framed_by_chunks != framed_at_once || framed_at_once.empty() || framed_at_once.back() != 0x11121314)
+    std::abort();
+  return 0;
+}
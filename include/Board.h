@@ -21,6 +21,8 @@
 #include <iostream>
 
 #include "Declarations.h"
+#include "MessageCodec.h"
+#include "ParcelPool.h"
 
 
 namespace board_connect{
@@ -45,9 +47,9 @@ public:
           const IBoardConnectorFactory<DataType>& connector_factory );
   
   Board(const Board& oth) = delete;
-  Board(const Board&& oth);
+  Board(Board&& oth) noexcept;             //connector with its threads stays in place, only ownership is moved.
   Board& operator=(const Board& oth) = delete;
-  Board& operator=(const Board&& oth);
+  Board& operator=(Board&& oth) noexcept;  //so std::vector<Board> may reallocate while boards are connected
   virtual ~Board() = default;
   
 public:
@@ -58,11 +60,17 @@ public:
   virtual ConnectionStatus Disconnect();
 
   //Send or operator>> for convenience
-  virtual bool Send(const DataType data);
-  virtual bool operator<<(const DataType data) { return Send(std::move(data)); }
+  virtual bool Send(const DataType& data);
+  virtual bool Send(DataType&& data);                         //data is moved into send queue, no copies
+  virtual bool operator<<(DataType data) { return Send(std::move(data)); }
+  template <typename... Args>
+  bool Emplace(Args&&... args);                               //parcel is constructed from args directly in send queue
+  virtual bool SendShared(SharedParcel<DataType> parcel);      //parcel is not copied, it may be shared between several boards
+  virtual bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length);   //bytes [offset, offset + length) of it
   
   virtual std::optional<DataType> Receive();
   virtual void operator>>(std::optional<DataType>& target) { target = Receive(); }
+  virtual std::optional<TimestampedParcel<DataType>> ReceiveTimestamped();    //same as Receive(), with time of arrival
 };
 
 /*  --------------------------------------------------------------------------------------------------------------------
@@ -81,18 +89,18 @@ Board<DataType>::Board(  const IConnectionSettings& settings,
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
-Board<DataType>::Board(const Board<DataType>&& oth) {
-  connector_ = std::move(oth.connector_);
-}
+Board<DataType>::Board(Board<DataType>&& oth) noexcept
+  : connector_(std::move(oth.connector_)) {}
 
 /*  --------------------------------------------------------------------------------------------------------------------
       Board:: move assignment
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
-Board<DataType>& Board<DataType>::operator=(const Board<DataType>&& oth) {
+Board<DataType>& Board<DataType>::operator=(Board<DataType>&& oth) noexcept {
   if(this == &oth) { return *this; }
-  connector_ = std::move(oth.connector_);
+  connector_ = std::move(oth.connector_);      //previous connector is disconnected by its destructor
+  return *this;
 }
 
 
@@ -135,21 +143,74 @@ ConnectionStatus Board<DataType>::Disconnect(){
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
-bool Board<DataType>::Send(const DataType data){
+bool Board<DataType>::Send(const DataType& data){
   return connector_->Send(data);
 }
 
 
+template <typename DataType>
+bool Board<DataType>::Send(DataType&& data){
+  return connector_->Send(std::move(data));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Board::Emplace
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+template <typename... Args>
+bool Board<DataType>::Emplace(Args&&... args){
+  if(connector_->Status() != ConnectionStatus_t::CONNECTED_OK)
+    return false;       //parcel is not constructed for nothing
+  return connector_->SendShared(MakeParcel<DataType>(std::forward<Args>(args)...));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Board::SendShared
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool Board<DataType>::SendShared(SharedParcel<DataType> parcel){
+  return connector_->SendShared(std::move(parcel));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Board::SendSlice
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool Board<DataType>::SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length){
+  return connector_->SendSlice(std::move(parcel), offset, length);
+}
+
+
 /*  --------------------------------------------------------------------------------------------------------------------
         Board::Receive
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
 std::optional<DataType> Board<DataType>::Receive(){
-  return connector_->Receive();
+  auto rx_data = ReceiveTimestamped();
+  if(!rx_data) {
+    return nullopt;
+  }
+  return std::move(rx_data->data);
 }  
 
 
+/*  --------------------------------------------------------------------------------------------------------------------
+        Board::ReceiveTimestamped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::optional<TimestampedParcel<DataType>> Board<DataType>::ReceiveTimestamped(){
+  return connector_->ReceiveTimestamped();
+}
+
+
 }  //namespace BoardConnect
 
 #endif     //BOARD_H
\ No newline at end of file
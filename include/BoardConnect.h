@@ -13,21 +13,101 @@
 
 #include "Declarations.h"
 #include "Board.h"
+#include "BoardGroup.h"
+#include "Dispatcher.h"
+#include "ThreadPool.h"
+#include "DecodePipeline.h"
+#include "SampleFrameDecoder.h"
+#include "ClockCorrelator.h"
 
+#include "ReliableConnectionSettings.h"
+#include "ReliableBoardConnector.h"
+
+#include "LoopbackConnectionSettings.h"
+#include "LoopbackBoardConnector.h"
+
+#ifdef BOARD_CONNECT_WINAPI
 #include "UartConnectionSettings.h"
 #include "UartBoardConnector.h"
+#include "SerialPortDiscovery.h"
+
+#include "SharedMemoryConnectionSettings.h"
+#include "SharedMemoryBoardConnector.h"
+#include "PublishingBoardConnector.h"
+#endif
 
 
 
 namespace board_connect{
 
 
+#ifdef BOARD_CONNECT_WINAPI
+
 template <typename DataType = DefaultDataType>
 Board<DataType> MakeUartBoard(const uart::UartConnectionSettings& uart_settings = uart::UartConnectionSettings()) { 
   return Board<DataType>(  uart_settings, uart::UartBoardConnectorFactory<DataType>()); 
 };
 
 
+template <typename DataType = DefaultDataType>
+Board<DataType> MakeSharedMemoryBoard(const shared_memory::SharedMemoryConnectionSettings& settings) { 
+  return Board<DataType>(  settings, shared_memory::SharedMemoryBoardConnectorFactory<DataType>()); 
+};
+
+
+  //Board over UART, which also publishes received parcels into shared memory ring for other processes
+template <typename DataType = DefaultDataType>
+Board<DataType> MakePublishingUartBoard(  const uart::UartConnectionSettings& uart_settings,
+                                          const shared_memory::PublishingConnectionSettings& publishing_settings) { 
+  return Board<DataType>(  publishing_settings, 
+                          shared_memory::PublishingBoardConnectorFactory<DataType>(uart_settings, uart::UartBoardConnectorFactory<DataType>())); 
+};
+
+
+  //Board over UART with acknowledgements and retransmission of lost parcels
+template <typename DataType = DefaultDataType>
+Board<DataType> MakeReliableUartBoard(  const uart::UartConnectionSettings& uart_settings = uart::UartConnectionSettings(),
+                                        const reliable::ReliableConnectionSettings& reliable_settings = reliable::ReliableConnectionSettings()) { 
+  return Board<DataType>(  reliable_settings, 
+                          reliable::ReliableBoardConnectorFactory<DataType>(uart_settings, uart::UartBoardConnectorFactory<DefaultDataType>())); 
+};
+
+
+  //Adds boards for ports found by watcher (any port, if filter is empty) and connects them, removes boards of
+  //disappeared ports. Boards are keyed by SerialPortInfo::Key(), settings of new board are base_settings with
+  //port name of found port. Ports found by one enumeration are connected in parallel by threads of the group
+  //(BoardGroup::StartConnect), so neither watcher nor other ports wait for a slow port. Board, which has failed
+  //to connect, stays in group: it may be connected later by ConnectAll().
+  //Callback keeps reference to group: watcher must be stopped before the group is destroyed.
+template <typename DataType = DefaultDataType>
+void AttachUartBoardsOnArrival(  uart::SerialPortWatcher& watcher, 
+                                BoardGroup<DataType>& group,
+                                const uart::UartConnectionSettings& base_settings = uart::UartConnectionSettings(),
+                                std::function<bool(const uart::SerialPortInfo&)> filter = nullptr,
+                                std::size_t max_parallel = 8,
+                                std::chrono::milliseconds timeout = std::chrono::milliseconds(5000) ) {
+  watcher.OnChange([&group, base_settings, filter, max_parallel, timeout]( const std::vector<uart::SerialPortInfo>& arrived,
+                                                                          const std::vector<uart::SerialPortInfo>& removed ){
+    for(const auto& info : removed) {
+      group.Remove(info.Key());
+    }
+
+    std::vector<std::string> new_keys;
+    for(const auto& info : arrived) {
+      if((filter && !filter(info)) || group.Contains(info.Key()))
+        continue;
+      group.Add(base_settings.WithPort(info.port_name), uart::UartBoardConnectorFactory<DataType>(), info.Key());
+      new_keys.push_back(info.Key());
+    }
+    if(!new_keys.empty()) {
+      group.StartConnect(new_keys, max_parallel, timeout);
+    }
+  });
+}
+
+#endif  //BOARD_CONNECT_WINAPI
+
+
 
 }  //board_connect
 
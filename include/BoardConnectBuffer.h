@@ -11,6 +11,7 @@
 
 #include <list>
 #include <optional>
+#include <type_traits>
 #include "Declarations.h"
 
 namespace board_connect {
@@ -22,23 +23,81 @@ using std::optional;
 using std::nullopt;
   
   
+/*  --------------------------------------------------------------------------------------------------------------------
+      Buffer
+      Thread-safe queue with peek / confirm reading. Any number of threads may Store(),
+      Load() + ConfirmReception() are intended for one consumer thread: with several consumers
+      the same parcel may be loaded twice, but it is never lost.
+      Nodes of removed parcels are kept and reused by Store(), so queue in steady state does not allocate.
+    --------------------------------------------------------------------------------------------------------------------
+*/
 template <typename DataType = DefaultDataType>
 class Buffer {
   
+    //node may be reused only if value in it can be released (reset to default) and replaced by assignment
+  constexpr static bool RECYCLE_NODES = std::is_nothrow_default_constructible_v<DataType> && std::is_nothrow_move_assignable_v<DataType>;
+  constexpr static std::size_t MAX_SPARE_NODES = 256;
+  
   list<DataType> storage_;
+  list<DataType> spare_nodes_;                //guarded by storage_mutex_
   mutex storage_mutex_;
-  bool await_load_confirmation_ = false;
+  bool await_load_confirmation_ = false;      //guarded by storage_mutex_
+  
+private:
+  template <typename T>
+  void Append(T&& data);
+  void RemoveFront();
   
 public:
 
   virtual                     ~Buffer() = default;
   virtual bool                Store(const DataType& data);
+  virtual bool                Store(DataType&& data);
   virtual optional<DataType>  Load();                        //Returns oldest parcel in queue. After this, need to call ConfirmReception().
   virtual bool                ConfirmReception();            //Removes oldest parcel from storage (this is to prevent lost of data in case of errors on caller's side)
                                                             //returns true if parcel is successfully erased. Consequental call of Load() will return new parcel.
+  virtual optional<DataType>  Take();                        //Load() and ConfirmReception() at once. Parcel is moved out, not copied
 };
 
 
+/*  --------------------------------------------------------------------------------------------------------------------
+      Buffer::Append()
+      storage_mutex_ must be locked by caller
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+template <typename T>
+void Buffer<DataType>::Append(T&& data) {
+  if constexpr (RECYCLE_NODES) {
+    if(!spare_nodes_.empty()) {
+        //if assignment throws, spare node stays where it was
+      spare_nodes_.front() = std::forward<T>(data);
+      storage_.splice(storage_.end(), spare_nodes_, spare_nodes_.begin());
+      return;
+    }
+  }
+  storage_.push_back(std::forward<T>(data));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Buffer::RemoveFront()
+      storage_mutex_ must be locked by caller, storage_ must not be empty
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void Buffer<DataType>::RemoveFront() {
+  if constexpr (RECYCLE_NODES) {
+    if(spare_nodes_.size() < MAX_SPARE_NODES) {
+      storage_.front() = DataType();      //parcel is released now, not when node is reused
+      spare_nodes_.splice(spare_nodes_.end(), storage_, storage_.begin());
+      return;
+    }
+  }
+  storage_.pop_front();
+}
+
+
 /*  --------------------------------------------------------------------------------------------------------------------
       Buffer::Store()
     --------------------------------------------------------------------------------------------------------------------
@@ -46,15 +105,18 @@ public:
 template <typename DataType>
 bool Buffer<DataType>::Store(const DataType& data) {
     //std::mutex may throw exception, in which case it's not locked
-    //if data throws anything (during copying), push_back has no effect. 
-    //rethrow exception in both cases
-  try {  
-    const lock_guard<mutex> lock(storage_mutex_);
-    storage_.push_back(data);   
-  }
-  catch(...) {
-    throw;  
-  }
+    //if data throws anything (during copying), Append has no effect. 
+    //exception goes to caller in both cases
+  const lock_guard<mutex> lock(storage_mutex_);
+  Append(data);
+  return true;
+}
+
+
+template <typename DataType>
+bool Buffer<DataType>::Store(DataType&& data) {
+  const lock_guard<mutex> lock(storage_mutex_);
+  Append(std::move(data));
   return true;
 }
 
@@ -65,12 +127,9 @@ bool Buffer<DataType>::Store(const DataType& data) {
 */
 template <typename DataType>
 optional<DataType> Buffer<DataType>::Load(){
-  try {  //std::mutex may throw exception, in which case it's not locked. rethrow exception
-    const lock_guard<mutex> lock(storage_mutex_);
-  }
-  catch(...) {
-    throw;  
-  }
+    //std::mutex may throw exception, in which case it's not locked and exception goes to caller.
+    //Lock is held until front parcel is copied: Store() and ConfirmReception() may run concurrently
+  const lock_guard<mutex> lock(storage_mutex_);
   
   if(storage_.empty())
     return nullopt;
@@ -86,15 +145,11 @@ optional<DataType> Buffer<DataType>::Load(){
 */
 template <typename DataType>
 bool Buffer<DataType>::ConfirmReception(){
-  try {  //std::mutex may throw exception, in which case it's not locked. rethrow exception
-    const lock_guard<mutex> lock(storage_mutex_);
-  }
-  catch(...) {
-    throw;  
-  }
+    //std::mutex may throw exception, in which case it's not locked and exception goes to caller
+  const lock_guard<mutex> lock(storage_mutex_);
   
   if(await_load_confirmation_ && !storage_.empty() ){
-    storage_.pop_front();
+    RemoveFront();
     await_load_confirmation_ = false;
     return true;
   }
@@ -102,6 +157,25 @@ bool Buffer<DataType>::ConfirmReception(){
 }
 
 
+/*  --------------------------------------------------------------------------------------------------------------------
+      Buffer::Take()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<DataType> Buffer<DataType>::Take(){
+  const lock_guard<mutex> lock(storage_mutex_);
+  
+  await_load_confirmation_ = false;
+  if(storage_.empty())
+    return nullopt;
+  
+    //if move throws, parcel stays in queue
+  optional<DataType> data(std::move(storage_.front()));
+  RemoveFront();
+  return data;
+}
+
+
 }  //board connect
 
 #endif  //BOARD_CONNECT_BUFFER_H
\ No newline at end of file
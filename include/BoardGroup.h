@@ -0,0 +1,520 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  class BoardGroup
+
+*/
+
+#ifndef BOARD_GROUP_H
+#define BOARD_GROUP_H
+
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+
+#include "Declarations.h"
+#include "Board.h"
+
+
+namespace board_connect{
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ParcelSlice
+      bytes [offset, offset + length) of raw parcel, see BoardGroup::Scatter
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct ParcelSlice{
+  std::size_t offset = 0;
+  std::size_t length = WHOLE_PARCEL;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      BoardConnectResult
+      Result of bring-up of one board
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct BoardConnectResult{
+  std::string key;
+  ConnectionStatus_t status = ConnectionStatus_t::UNDEFINED;
+  bool already_connected = false;             //board was connected before, Connect() was not called
+  bool timed_out = false;                     //Connect() has not finished (or started) within timeout. It is not cancelled:
+                                              //board becomes connected later, if the attempt succeeds
+  std::chrono::milliseconds elapsed{0};
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ConnectAllReport
+      Result of BoardGroup::ConnectAll() / Connect(). Results are in order of boards in group
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct ConnectAllReport{
+  std::vector<BoardConnectResult> boards;
+  std::size_t connected_count = 0;
+  std::chrono::milliseconds elapsed{0};
+
+  bool AllConnected() const { return connected_count == boards.size(); }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      class BoardGroup declaration
+      Owns several boards (for example, all boards in a rack) and allows to address them at once.
+      Each board may have a key (e.g. instance id of its serial port), which allows to remove it.
+      Boards are allocated separately, so references returned by Add() stay valid until the board is removed.
+      Boards may be added and removed from another thread (e.g. by SerialPortWatcher) while group is in use:
+      operator[] and Find() return shared ownership, board stays alive while it's used, even if it's removed.
+      Bring-up threads are owned by group, destructor waits for Connect() attempts, which are still in progress.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class BoardGroup{
+
+  struct Member{
+    std::string key;
+    std::shared_ptr<Board<DataType>> board;
+  };
+
+  struct BringUp;
+
+  struct BringUpWorker{
+    thread th;
+    std::shared_ptr<std::atomic_bool> finished;
+  };
+
+  std::vector<Member> boards_;
+  mutable std::mutex boards_mutex_;
+
+  std::vector<BringUpWorker> workers_;      //guarded by workers_mutex_
+  std::mutex workers_mutex_;
+
+private:
+  std::vector<Member> MembersWithKeys(const std::vector<std::string>& keys) const;
+  std::shared_ptr<BringUp> StartBringUp(std::vector<Member> members, std::size_t max_parallel, std::chrono::milliseconds timeout);
+  ConnectAllReport ConnectMembers(std::vector<Member> members, std::size_t max_parallel, std::chrono::milliseconds timeout);
+  void JoinWorkers(bool finished_only);
+
+public:
+  //ctor / dtor
+  BoardGroup() = default;
+  BoardGroup(const BoardGroup& oth) = delete;
+  BoardGroup& operator=(const BoardGroup& oth) = delete;
+  virtual ~BoardGroup() { WaitBringUp(); }
+
+public:
+  //API
+
+  virtual Board<DataType>& Add(  const IConnectionSettings& settings,
+                                const IBoardConnectorFactory<DataType>& connector_factory,
+                                std::string key = std::string() );
+  virtual bool Remove(const std::string& key);       //disconnects and removes boards with the key. False if there are none
+  bool Contains(const std::string& key) const;
+
+  std::size_t Size() const;
+  std::shared_ptr<Board<DataType>> operator[](std::size_t index) const;    //index changes when preceding board is removed
+  std::shared_ptr<Board<DataType>> Find(const std::string& key) const;     //the first board with the key, nullptr if none
+
+  //Connects all boards, which are not connected yet, concurrently in background threads, at most max_parallel at once.
+  //Returns when all attempts are finished or timeout expires. Attempts, which have not finished by then, are reported
+  //as timed out and go on in background (Connect() can not be interrupted); boards not started by then are not connected.
+  //Group is not locked during bring-up: boards may be used, added and removed meanwhile.
+  virtual ConnectAllReport ConnectAll(  std::size_t max_parallel = 8,
+                                        std::chrono::milliseconds timeout = std::chrono::milliseconds(5000) );
+  //The same for boards with given keys only (e.g. boards just added for new ports)
+  virtual ConnectAllReport Connect(  const std::vector<std::string>& keys,
+                                    std::size_t max_parallel = 8,
+                                    std::chrono::milliseconds timeout = std::chrono::milliseconds(5000) );
+  //Starts bring-up of boards with given keys and returns at once, e.g. on thread, which must not be blocked
+  //by slow ports. Boards not started within timeout are not connected.
+  virtual void StartConnect(  const std::vector<std::string>& keys,
+                              std::size_t max_parallel = 8,
+                              std::chrono::milliseconds timeout = std::chrono::milliseconds(5000) );
+  //Waits until all bring-up threads have finished (Connect() attempts, which went on after timeout, included)
+  void WaitBringUp();
+
+  //Sends the same parcel to every board. Parcel is allocated once and shared between all send queues.
+  //Returns true if parcel is accepted by all boards.
+  virtual bool Broadcast(DataType data);
+  virtual bool Broadcast(SharedParcel<DataType> parcel);
+
+  //Sends slices[i] of one shared buffer to i-th board (e.g. per-board parts of a frame). Buffer is not copied:
+  //every send queue keeps a reference to it and a range of its raw bytes, buffer is freed after the last send.
+  //Returns true if number of slices matches number of boards and all slices are accepted.
+  virtual bool Scatter(SharedParcel<DataType> buffer, const std::vector<ParcelSlice>& slices);
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      BoardGroup::BringUp
+      State of one bring-up, shared by its threads and the caller, who waits for results only until deadline
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+struct BoardGroup<DataType>::BringUp{
+  std::vector<Member> members;
+  std::vector<BoardConnectResult> results;      //guarded by results_mutex
+  std::vector<std::size_t> pending;             //indices of boards to connect
+  std::size_t next_pending = 0;                 //guarded by results_mutex
+  std::size_t finished_count = 0;               //guarded by results_mutex
+  std::mutex results_mutex;
+  std::condition_variable finished_cv;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point deadline;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Definitions of BoardGroup:: methods
+    --------------------------------------------------------------------------------------------------------------------
+*/
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Add
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+Board<DataType>& BoardGroup<DataType>::Add(  const IConnectionSettings& settings,
+                                            const IBoardConnectorFactory<DataType>& connector_factory,
+                                            std::string key ) {
+  auto board = std::make_shared<Board<DataType>>(settings, connector_factory);
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  boards_.push_back({ std::move(key), board });
+  return *board;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Remove
+        Board is disconnected out of lock: it may take time to stop its service threads
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool BoardGroup<DataType>::Remove(const std::string& key) {
+  std::vector<std::shared_ptr<Board<DataType>>> removed;
+  {
+    const std::lock_guard<std::mutex> lock(boards_mutex_);
+    for(auto it = boards_.begin(); it != boards_.end(); ) {
+      if(it->key == key) {
+        removed.push_back(std::move(it->board));
+        it = boards_.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+  for(auto& board : removed) {
+    board->Disconnect();
+  }
+  return !removed.empty();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Contains
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool BoardGroup<DataType>::Contains(const std::string& key) const {
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  return std::any_of(boards_.begin(), boards_.end(), [&key](const Member& member){ return member.key == key; });
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Size
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::size_t BoardGroup<DataType>::Size() const {
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  return boards_.size();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::operator[]
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::shared_ptr<Board<DataType>> BoardGroup<DataType>::operator[](std::size_t index) const {
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  return boards_.at(index).board;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Find
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::shared_ptr<Board<DataType>> BoardGroup<DataType>::Find(const std::string& key) const {
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  const auto it = std::find_if(boards_.begin(), boards_.end(), [&key](const Member& member){ return member.key == key; });
+  return it == boards_.end() ? nullptr : it->board;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::ConnectAll
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectAllReport BoardGroup<DataType>::ConnectAll(std::size_t max_parallel, std::chrono::milliseconds timeout){
+  std::vector<Member> members;
+  {
+    const std::lock_guard<std::mutex> lock(boards_mutex_);
+    members = boards_;
+  }
+  return ConnectMembers(std::move(members), max_parallel, timeout);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Connect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectAllReport BoardGroup<DataType>::Connect(const std::vector<std::string>& keys, std::size_t max_parallel, std::chrono::milliseconds timeout){
+  return ConnectMembers(MembersWithKeys(keys), max_parallel, timeout);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::StartConnect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void BoardGroup<DataType>::StartConnect(const std::vector<std::string>& keys, std::size_t max_parallel, std::chrono::milliseconds timeout){
+  StartBringUp(MembersWithKeys(keys), max_parallel, timeout);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::WaitBringUp
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void BoardGroup<DataType>::WaitBringUp(){
+  JoinWorkers(false);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::MembersWithKeys
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::vector<typename BoardGroup<DataType>::Member> BoardGroup<DataType>::MembersWithKeys(const std::vector<std::string>& keys) const {
+  std::vector<Member> members;
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  for(const auto& member : boards_) {
+    if(std::find(keys.begin(), keys.end(), member.key) != keys.end()) {
+      members.push_back(member);
+    }
+  }
+  return members;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::JoinWorkers
+        Threads are joined out of lock: bring-up may be started meanwhile by another thread
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void BoardGroup<DataType>::JoinWorkers(bool finished_only){
+  std::vector<BringUpWorker> joined;
+  {
+    const std::lock_guard<std::mutex> lock(workers_mutex_);
+    for(auto it = workers_.begin(); it != workers_.end(); ) {
+      if(!finished_only || it->finished->load()) {
+        joined.push_back(std::move(*it));
+        it = workers_.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+  for(auto& worker : joined) {
+    worker.th.join();
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::StartBringUp
+        Device opening dominates bring-up time, so boards are connected by a bounded set of threads,
+        each of them takes next not yet connected board until deadline. Threads keep the boards and the results
+        alive and are joined by later bring-ups (when finished) or by WaitBringUp().
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::shared_ptr<typename BoardGroup<DataType>::BringUp> BoardGroup<DataType>::StartBringUp(  std::vector<Member> members,
+                                                                                              std::size_t max_parallel,
+                                                                                              std::chrono::milliseconds timeout){
+  using std::chrono::steady_clock;
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+
+  JoinWorkers(true);
+
+  auto bring_up = std::make_shared<BringUp>();
+  bring_up->start = steady_clock::now();
+  bring_up->deadline = bring_up->start + timeout;
+  bring_up->results.resize(members.size());
+  for(std::size_t i = 0; i < members.size(); ++i) {
+    bring_up->results[i].key = members[i].key;
+    if(members[i].board->Status() == ConnectionStatus_t::CONNECTED_OK) {
+      bring_up->results[i].status = ConnectionStatus_t::CONNECTED_OK;
+      bring_up->results[i].already_connected = true;
+    }
+    else {
+      bring_up->pending.push_back(i);
+    }
+  }
+  bring_up->members = std::move(members);
+
+  auto connect_routine = [bring_up](){
+    while(true) {
+      std::size_t i;
+      {
+        const std::lock_guard<std::mutex> lock(bring_up->results_mutex);
+        if(bring_up->next_pending == bring_up->pending.size() || steady_clock::now() >= bring_up->deadline)
+          return;
+        i = bring_up->pending[bring_up->next_pending++];
+      }
+
+      ConnectionStatus_t status;
+      const auto board_start = steady_clock::now();
+      try{
+        status = bring_up->members[i].board->Connect().value;
+      }
+      catch(...){
+        status = ConnectionStatus_t::OTHER_ERROR;
+      }
+
+      {
+        const std::lock_guard<std::mutex> lock(bring_up->results_mutex);
+        bring_up->results[i].status = status;
+        bring_up->results[i].elapsed = duration_cast<milliseconds>(steady_clock::now() - board_start);
+        ++bring_up->finished_count;
+      }
+      bring_up->finished_cv.notify_all();
+    }
+  };
+
+  if(max_parallel == 0)
+    max_parallel = 1;
+  const std::size_t threads_count = std::min(max_parallel, bring_up->pending.size());
+  std::size_t started_count = 0;
+  for(; started_count < threads_count; ++started_count) {
+    try{
+      const std::lock_guard<std::mutex> lock(workers_mutex_);
+      workers_.reserve(workers_.size() + 1);        //push_back of started thread must not throw
+      auto finished = std::make_shared<std::atomic_bool>(false);
+      thread th{[connect_routine, finished](){
+        connect_routine();
+        finished->store(true);
+      }};
+      workers_.push_back({ std::move(th), std::move(finished) });
+    }
+    catch(...){
+      break;    //unable to create more threads, continue with already created ones
+    }
+  }
+  if(started_count == 0 && threads_count > 0) {
+    connect_routine();      //no threads at all: calling thread connects, timeout can't be kept
+  }
+  return bring_up;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::ConnectMembers
+        Waits for bring-up only until deadline
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectAllReport BoardGroup<DataType>::ConnectMembers(std::vector<Member> members, std::size_t max_parallel, std::chrono::milliseconds timeout){
+  using std::chrono::steady_clock;
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+
+  const std::shared_ptr<BringUp> bring_up = StartBringUp(std::move(members), max_parallel, timeout);
+
+  ConnectAllReport report;
+  {
+    std::unique_lock<std::mutex> lock(bring_up->results_mutex);
+    bring_up->finished_cv.wait_until(lock, bring_up->deadline, [&bring_up]{
+      return bring_up->finished_count == bring_up->pending.size();
+    });
+    report.boards = bring_up->results;
+  }
+
+  for(std::size_t i : bring_up->pending) {
+    BoardConnectResult& result = report.boards[i];
+    if(result.status == ConnectionStatus_t::UNDEFINED) {
+      result.timed_out = true;
+      result.elapsed = timeout;
+    }
+  }
+  for(const auto& result : report.boards) {
+    if(result.status == ConnectionStatus_t::CONNECTED_OK)
+      ++report.connected_count;
+  }
+  report.elapsed = duration_cast<milliseconds>(steady_clock::now() - bring_up->start);
+  return report;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Broadcast
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool BoardGroup<DataType>::Broadcast(DataType data){
+  return Broadcast(MakeParcel<DataType>(std::move(data)));
+}
+
+
+template <typename DataType>
+bool BoardGroup<DataType>::Broadcast(SharedParcel<DataType> parcel){
+  if(!parcel)
+    return false;
+
+    //enqueueing is cheap: actual writes are performed in parallel by sender threads of each connector
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  bool all_accepted = true;
+  for(auto& member : boards_) {
+    all_accepted &= member.board->SendShared(parcel);
+  }
+  return all_accepted;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        BoardGroup::Scatter
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool BoardGroup<DataType>::Scatter(SharedParcel<DataType> buffer, const std::vector<ParcelSlice>& slices){
+  const std::lock_guard<std::mutex> lock(boards_mutex_);
+  if(!buffer || slices.size() != boards_.size())
+    return false;
+
+  bool all_accepted = true;
+  for(std::size_t i = 0; i < boards_.size(); ++i) {
+    all_accepted &= boards_[i].board->SendSlice(buffer, slices[i].offset, slices[i].length);
+  }
+  return all_accepted;
+}
+
+
+}  //namespace board_connect
+
+#endif     //BOARD_GROUP_H
@@ -0,0 +1,225 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  class ClockCorrelator
+
+*/
+
+#ifndef CLOCK_CORRELATOR_H
+#define CLOCK_CORRELATOR_H
+
+#include <deque>
+#include <optional>
+#include <cstdint>
+
+#include "Declarations.h"
+
+
+namespace board_connect{
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      class ClockCorrelator declaration
+      Estimates relation between board clock and host clock:
+        host_time = offset + drift * board_time
+      by least squares regression over the last window_size pairs (board timestamp, host receive timestamp).
+      Board time is given in ticks, ticks_per_second is nominal frequency of board clock.
+      Board counter of counter_bits bits wraps around: ticks are unwrapped relative to the previous sample,
+      so samples must come more often than half of counter period. With 64 bits ticks are taken as they are.
+      Regression sums are updated in O(1) per sample and recomputed from the window once per window_size samples,
+      so rounding errors do not accumulate.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class ClockCorrelator{
+
+  struct Sample{
+    long double board_seconds;
+    long double host_seconds;
+  };
+
+  const long double ticks_per_second_;
+  const std::size_t window_size_;
+  const unsigned counter_bits_;
+
+  std::mutex samples_mutex_;
+  std::deque<Sample> samples_;
+  std::optional<TimePoint_t> host_origin_;      //host times are kept relative to the first sample to preserve precision
+  long long last_ticks_ = 0;                    //unwrapped ticks of the last sample
+  std::size_t updates_count_ = 0;               //since sums were recomputed
+
+    //means and centered sums of the window
+  long double mean_board_ = 0;
+  long double mean_host_ = 0;
+  long double covariance_ = 0;                  //sum of (board - mean_board) * (host - mean_host)
+  long double variance_ = 0;                    //sum of (board - mean_board)^2
+
+  long double offset_ = 0;                      //host seconds since host_origin_ at board time 0
+  long double drift_ = 1;                       //host seconds per board second
+
+private:
+  long long Unwrap(long long board_ticks) const;
+  void Include(const Sample& sample);
+  void Exclude(const Sample& sample);
+  void Recompute();
+  void Estimate();
+
+public:
+  //ctor / dtor
+  explicit ClockCorrelator(long double ticks_per_second = 1.0e6L, std::size_t window_size = 256, unsigned counter_bits = 64)
+    : ticks_per_second_(ticks_per_second), window_size_(window_size < 2 ? 2 : window_size),
+      counter_bits_(counter_bits == 0 || counter_bits > 64 ? 64 : counter_bits) {}
+  ClockCorrelator(const ClockCorrelator& oth) = delete;
+  ClockCorrelator& operator=(const ClockCorrelator& oth) = delete;
+  virtual ~ClockCorrelator() = default;
+
+public:
+  //API
+  void AddSample(long long board_ticks, TimePoint_t host_time);
+  std::optional<TimePoint_t> ToHostTime(long long board_ticks);      //nullopt until there are at least two samples.
+                                                                     //Ticks are unwrapped relative to the last sample
+  double Drift();                                                    //ratio of host clock rate to board clock rate
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::AddSample
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void ClockCorrelator::AddSample(long long board_ticks, TimePoint_t host_time) {
+  const std::lock_guard<std::mutex> lock(samples_mutex_);
+  if(!host_origin_) {
+    host_origin_ = host_time;
+    last_ticks_ = board_ticks;
+  }
+  last_ticks_ = Unwrap(board_ticks);
+  const std::chrono::duration<long double> host_seconds = host_time - *host_origin_;
+  const Sample sample{ last_ticks_ / ticks_per_second_, host_seconds.count() };
+
+  if(samples_.size() == window_size_) {
+    Exclude(samples_.front());
+    samples_.pop_front();
+  }
+  samples_.push_back(sample);
+  if(++updates_count_ >= window_size_) {
+    Recompute();
+  }
+  else {
+    Include(sample);
+  }
+  Estimate();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::Unwrap
+      Counter of counter_bits_ bits: difference from the last sample modulo counter period, taken as signed
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline long long ClockCorrelator::Unwrap(long long board_ticks) const {
+  if(counter_bits_ >= 64)
+    return board_ticks;
+  const std::uint64_t mask = (std::uint64_t{1} << counter_bits_) - 1;
+  std::uint64_t step = (static_cast<std::uint64_t>(board_ticks) - static_cast<std::uint64_t>(last_ticks_)) & mask;
+  if(step > (mask >> 1)) {
+    step -= mask + 1;       //backwards (e.g. reordered sample): two's complement of the negative step
+  }
+  return static_cast<long long>(static_cast<std::uint64_t>(last_ticks_) + step);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::Include / Exclude
+      Welford updates of means and centered sums. samples_ already contains (Include) or still contains
+      (Exclude) the sample
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void ClockCorrelator::Include(const Sample& sample) {
+  const long double count = static_cast<long double>(samples_.size());
+  const long double d_board = sample.board_seconds - mean_board_;
+  mean_board_ += d_board / count;
+  mean_host_ += (sample.host_seconds - mean_host_) / count;
+  covariance_ += d_board * (sample.host_seconds - mean_host_);
+  variance_ += d_board * (sample.board_seconds - mean_board_);
+}
+
+
+inline void ClockCorrelator::Exclude(const Sample& sample) {
+  const long double count = static_cast<long double>(samples_.size()) - 1;      //after exclusion, at least 1
+  const long double old_mean_host = mean_host_;
+  const long double old_mean_board = mean_board_;
+  mean_board_ -= (sample.board_seconds - mean_board_) / count;
+  mean_host_ -= (sample.host_seconds - mean_host_) / count;
+  covariance_ -= (sample.board_seconds - mean_board_) * (sample.host_seconds - old_mean_host);
+  variance_ -= (sample.board_seconds - mean_board_) * (sample.board_seconds - old_mean_board);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::Recompute
+      Sums are computed around mean values to avoid cancellation
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void ClockCorrelator::Recompute() {
+  updates_count_ = 0;
+  mean_board_ = 0;
+  mean_host_ = 0;
+  for(const auto& sample : samples_) {
+    mean_board_ += sample.board_seconds;
+    mean_host_ += sample.host_seconds;
+  }
+  mean_board_ /= samples_.size();
+  mean_host_ /= samples_.size();
+
+  covariance_ = 0;
+  variance_ = 0;
+  for(const auto& sample : samples_) {
+    const long double d_board = sample.board_seconds - mean_board_;
+    covariance_ += d_board * (sample.host_seconds - mean_host_);
+    variance_ += d_board * d_board;
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::Estimate
+      Ordinary least squares over the window
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void ClockCorrelator::Estimate() {
+  if(samples_.size() < 2 || variance_ <= 0)
+    return;     //all board timestamps are equal, keep previous estimation
+
+  drift_ = covariance_ / variance_;
+  offset_ = mean_host_ - drift_ * mean_board_;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::ToHostTime
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::optional<TimePoint_t> ClockCorrelator::ToHostTime(long long board_ticks) {
+  const std::lock_guard<std::mutex> lock(samples_mutex_);
+  if(samples_.size() < 2)
+    return std::nullopt;
+
+  const std::chrono::duration<long double> host_seconds{ offset_ + drift_ * (Unwrap(board_ticks) / ticks_per_second_) };
+  return *host_origin_ + std::chrono::duration_cast<Clock_t::duration>(host_seconds);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ClockCorrelator::Drift
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline double ClockCorrelator::Drift() {
+  const std::lock_guard<std::mutex> lock(samples_mutex_);
+  return static_cast<double>(drift_);
+}
+
+
+}  //namespace board_connect
+
+#endif     //CLOCK_CORRELATOR_H
@@ -24,8 +24,16 @@
 
 //#define NDEBUG
 
+  //connectors to UART and shared memory need WinApi. Without it (e.g. Linux build of tests under
+  //ThreadSanitizer) Board, queues, BoardGroup, Dispatcher, codec, reliable and loopback layers are available
+#if defined(_WIN32) && !defined(BOARD_CONNECT_WINAPI)
+#define BOARD_CONNECT_WINAPI
+#endif
+
+#ifdef BOARD_CONNECT_WINAPI
 #include <winsock2.h>
 #include <windows.h>
+#endif
 
 //#pragma comment(lib, "Ws2_32.lib")
 //GCC does not support this. Use  g++ ... -lWs2_32
@@ -41,7 +49,9 @@ using std::atomic_bool;
   
 using DefaultDataType = std::string;
 
+#ifdef BOARD_CONNECT_WINAPI
 using Handler = HANDLE;
+#endif
 
 template <typename DataType> class IBoardConnector;
 class IConnectionSettings;
@@ -53,6 +63,35 @@ using IConnectionSettings_up = std::unique_ptr<const IConnectionSettings>;
 template <typename DataType>
 using IBoardConnector_up = std::unique_ptr< IBoardConnector<DataType> >;
 
+  //immutable parcel, which may be shared between send queues of several connectors (see BoardGroup::Broadcast)
+template <typename DataType>
+using SharedParcel = std::shared_ptr<const DataType>;
+
+constexpr std::size_t WHOLE_PARCEL = std::numeric_limits<std::size_t>::max();
+
+  //element of send queue: bytes [offset, offset + length) of raw representation of shared parcel.
+  //Several boards may send different parts of one buffer without copying it (see BoardGroup::Scatter)
+template <typename DataType>
+struct OutgoingParcel{
+  SharedParcel<DataType> parcel;
+  std::size_t offset = 0;
+  std::size_t length = WHOLE_PARCEL;
+};
+
+using Clock_t = std::chrono::steady_clock;      //monotonic, based on QueryPerformanceCounter on Windows
+using TimePoint_t = Clock_t::time_point;
+
+  //received parcel and the moment when read of it has returned
+template <typename DataType>
+struct TimestampedParcel{
+  DataType data;
+  TimePoint_t timestamp;
+
+    //default constructor of time_point is not declared noexcept: stated here, so receive queues reuse their nodes
+  TimestampedParcel() noexcept(std::is_nothrow_default_constructible_v<DataType>) : data(), timestamp(Clock_t::duration::zero()) {}
+  TimestampedParcel(DataType d, TimePoint_t t) : data(std::move(d)), timestamp(t) {}
+};
+
 enum class ConnectionStatus_t { UNDEFINED, CONNECTED_OK, DISCONNECTED_OK, CONNECTION_LOST, CONNECTION_ERROR, OTHER_ERROR, CONNECTION_IN_PROGRESS, DISCONNECTION_IN_PROGRESS };
 
 
@@ -60,6 +99,7 @@ enum class ConnectionStatus_t { UNDEFINED, CONNECTED_OK, DISCONNECTED_OK, CONNEC
       constants for WinApi
     --------------------------------------------------------------------------------------------------------------------
 */
+#ifdef BOARD_CONNECT_WINAPI
 const COMMTIMEOUTS DEFAULT_COMMTIMEOUTS{ 
   MAXDWORD,    // ReadIntervalTimeout
   0,          // ReadTotalTimeoutMultiplier
@@ -67,6 +107,7 @@ const COMMTIMEOUTS DEFAULT_COMMTIMEOUTS{
   0,          // WriteTotalTimeoutMultiplier
   0            // WriteTotalTimeoutConstant
 };
+#endif
 
 
 /*  --------------------------------------------------------------------------------------------------------------------
@@ -105,7 +146,7 @@ public:
       Getting data from DataType (string by default)
     --------------------------------------------------------------------------------------------------------------------
 */
-char* Data(DefaultDataType obj){
+const char* Data(const DefaultDataType& obj){
   return obj.data();
 }
 
@@ -0,0 +1,310 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  class DecodePipeline
+
+*/
+
+#ifndef DECODE_PIPELINE_H
+#define DECODE_PIPELINE_H
+
+#include <map>
+#include <algorithm>
+#include <optional>
+#include <functional>
+#include <condition_variable>
+
+#include "Declarations.h"
+#include "Board.h"
+#include "ThreadPool.h"
+
+
+namespace board_connect{
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      class DecodePipeline declaration
+      Converts raw frames received by a board into user DataType objects on WorkStealingPool.
+      Frames are decoded in parallel, but Receive() returns them in the order they were received:
+      each frame gets sequence number and decoded objects are released strictly by sequence.
+      One pool may be shared by pipelines of several boards.
+      Board.Receive() of a stream connector (UART) returns chunks as they were read from the driver, not frames:
+      such pipeline needs a framer, which splits the stream into frames before they are submitted
+      (see FixedSizeFramer, DelimiterFramer). Without framer every received parcel is treated as one frame,
+      which is right for connectors keeping message boundaries (reliable, shared memory).
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType = DefaultDataType>
+class DecodePipeline{
+
+public:
+  using Decoder_t = std::function<DataType(const RawType&)>;
+  using Emit_t = std::function<void(RawType)>;
+  using Framer_t = std::function<void(const RawType& chunk, const Emit_t& emit)>;    //calls emit for every completed frame
+
+private:
+  const Decoder_t decoder_;
+  WorkStealingPool& pool_;
+  Framer_t framer_;                                           //used by feeder thread only
+
+  std::mutex ready_mutex_;
+  std::condition_variable ready_cv_;
+  std::map<unsigned long long, std::optional<DataType>> ready_;    //nullopt if decoder has thrown. Guarded by ready_mutex_
+  unsigned long long next_submit_seq_ = 0;                    //guarded by ready_mutex_
+  unsigned long long next_receive_seq_ = 0;                   //guarded by ready_mutex_
+  std::size_t in_flight_ = 0;                                 //guarded by ready_mutex_
+
+  struct ThreadWrapper{
+    thread th;
+    atomic_bool join_request;
+  };
+  ThreadWrapper feeder_thread_;
+
+private:
+  void FeederLoop(Board<RawType>& board, std::chrono::milliseconds idle_period) noexcept;
+  void Complete(unsigned long long seq, std::optional<DataType> decoded);
+
+public:
+  //ctor / dtor
+  DecodePipeline(Decoder_t decoder, WorkStealingPool& pool, Framer_t framer = nullptr) :
+                  decoder_(std::move(decoder)), pool_(pool), framer_(std::move(framer)) {
+    feeder_thread_.join_request.store(false, std::memory_order_relaxed);
+  }
+  DecodePipeline(const DecodePipeline& oth) = delete;
+  DecodePipeline& operator=(const DecodePipeline& oth) = delete;
+  virtual ~DecodePipeline();
+
+public:
+  //API
+  virtual bool Submit(RawType raw);                   //false if pool is shut down, frame is dropped then
+  virtual std::optional<DataType> Receive();         //next decoded object in order of submission, nullopt if it is not ready yet
+
+  //Starts thread, which pulls raw data from board.Receive(), splits it by framer and submits frames for decoding
+  virtual void Start(Board<RawType>& board, std::chrono::milliseconds idle_period = std::chrono::milliseconds(1));
+  virtual void Stop() noexcept;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      DecodePipeline:: destructor
+      Waits for frames being decoded, as their tasks refer to this pipeline
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+DecodePipeline<DataType, RawType>::~DecodePipeline() {
+  Stop();
+  std::unique_lock<std::mutex> lock(ready_mutex_);
+  ready_cv_.wait(lock, [this]{ return in_flight_ == 0; });
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Definitions of DecodePipeline:: methods
+    --------------------------------------------------------------------------------------------------------------------
+*/
+/*  --------------------------------------------------------------------------------------------------------------------
+        DecodePipeline::Submit
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+bool DecodePipeline<DataType, RawType>::Submit(RawType raw){
+  unsigned long long seq;
+  {
+    const std::lock_guard<std::mutex> lock(ready_mutex_);
+    seq = next_submit_seq_++;
+    ++in_flight_;
+  }
+
+  bool accepted;
+  try{
+    accepted = pool_.Submit([this, seq, raw = std::move(raw)](){
+      std::optional<DataType> decoded;
+      try{
+        decoded = decoder_(raw);
+      }
+      catch(...){
+        cout<<"Error during decoding frame"<<endl;
+      }
+      Complete(seq, std::move(decoded));
+    });
+  }
+  catch(...){
+    Complete(seq, std::nullopt);     //keep sequence without gaps
+    throw;
+  }
+  if(!accepted) {
+    Complete(seq, std::nullopt);     //task will never run, destructor must not wait for it
+  }
+  return accepted;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        DecodePipeline::Complete
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+void DecodePipeline<DataType, RawType>::Complete(unsigned long long seq, std::optional<DataType> decoded){
+  //notify under lock: destructor may destroy pipeline as soon as in_flight_ becomes zero
+  const std::lock_guard<std::mutex> lock(ready_mutex_);
+  ready_.emplace(seq, std::move(decoded));
+  --in_flight_;
+  ready_cv_.notify_all();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        DecodePipeline::Receive
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+std::optional<DataType> DecodePipeline<DataType, RawType>::Receive(){
+  const std::lock_guard<std::mutex> lock(ready_mutex_);
+  while(!ready_.empty() && ready_.begin()->first == next_receive_seq_) {
+    auto decoded = std::move(ready_.begin()->second);
+    ready_.erase(ready_.begin());
+    ++next_receive_seq_;
+    if(decoded)
+      return decoded;
+    //frames which failed to decode are skipped
+  }
+  return std::nullopt;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        DecodePipeline::Start
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+void DecodePipeline<DataType, RawType>::Start(Board<RawType>& board, std::chrono::milliseconds idle_period){
+  if(feeder_thread_.th.joinable())
+    return;
+  feeder_thread_.join_request.store(false, std::memory_order_relaxed);
+
+  //exception may be thrown if's impossible to create a new thread
+  feeder_thread_.th = thread{&DecodePipeline<DataType, RawType>::FeederLoop, this, std::ref(board), idle_period};
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        DecodePipeline::Stop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+void DecodePipeline<DataType, RawType>::Stop() noexcept{
+  feeder_thread_.join_request.store(true, std::memory_order_relaxed);
+  if(feeder_thread_.th.joinable()) {
+    feeder_thread_.th.join();
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        DecodePipeline::FeederLoop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, typename RawType>
+void DecodePipeline<DataType, RawType>::FeederLoop(Board<RawType>& board, std::chrono::milliseconds idle_period) noexcept{
+  auto& stop_request_atomic = feeder_thread_.join_request;
+  while(!stop_request_atomic.load(std::memory_order_relaxed)) {
+    try{
+      auto raw = board.Receive();
+      if(raw){
+        if(framer_) {
+          framer_(*raw, [this](RawType frame){ Submit(std::move(frame)); });
+        }
+        else {
+          Submit(std::move(*raw));
+        }
+        continue;
+      }
+    }
+    catch(...){
+      cout<<"Error in decode pipeline feeder loop"<<endl;
+    }
+    std::this_thread::sleep_for(idle_period);
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      FixedSizeFramer
+      Framer for DecodePipeline<..., std::string>: splits byte stream into frames of frame_size bytes.
+      Tail of the chunk is kept till the next chunk
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class FixedSizeFramer{
+  std::size_t frame_size_;
+  std::string pending_;
+
+public:
+  explicit FixedSizeFramer(std::size_t frame_size) : frame_size_(frame_size == 0 ? 1 : frame_size) {}
+
+  void operator()(const std::string& chunk, const std::function<void(std::string)>& emit) {
+    std::size_t position = 0;
+    if(!pending_.empty()) {
+      position = std::min(frame_size_ - pending_.size(), chunk.size());
+      pending_.append(chunk, 0, position);
+      if(pending_.size() < frame_size_)
+        return;
+      emit(std::move(pending_));
+      pending_.clear();
+    }
+    for(; chunk.size() - position >= frame_size_; position += frame_size_) {
+      emit(chunk.substr(position, frame_size_));
+    }
+    pending_.assign(chunk, position, std::string::npos);
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      DelimiterFramer
+      Framer for DecodePipeline<..., std::string>: frame ends with delimiter (e.g. '\n' for text protocols).
+      Delimiter is not included into frame, empty frames are skipped. Frame longer than max_frame_size is dropped
+      up to the next delimiter, so lost delimiter does not make the buffer grow
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class DelimiterFramer{
+  char delimiter_;
+  std::size_t max_frame_size_;
+  std::string pending_;
+  bool overflow_ = false;
+
+public:
+  explicit DelimiterFramer(char delimiter = '\n', std::size_t max_frame_size = 4096) :
+                            delimiter_(delimiter), max_frame_size_(max_frame_size) {}
+
+  void operator()(const std::string& chunk, const std::function<void(std::string)>& emit) {
+    std::size_t position = 0;
+    while(position < chunk.size()) {
+      const std::size_t end = chunk.find(delimiter_, position);
+      const std::size_t length = (end == std::string::npos ? chunk.size() : end) - position;
+      if(!overflow_) {
+        if(pending_.size() + length > max_frame_size_) {
+          overflow_ = true;
+          pending_.clear();
+        }
+        else {
+          pending_.append(chunk, position, length);
+        }
+      }
+      if(end == std::string::npos)
+        return;
+      if(!overflow_ && !pending_.empty()) {
+        emit(std::move(pending_));
+      }
+      pending_.clear();
+      overflow_ = false;
+      position = end + 1;
+    }
+  }
+};
+
+
+}  //namespace board_connect
+
+#endif     //DECODE_PIPELINE_H
@@ -0,0 +1,318 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  class Dispatcher
+
+*/
+
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include "Declarations.h"
+#include "Board.h"
+
+
+namespace board_connect{
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Getting dispatch key from DataType (header byte of string by default)
+      Overload this function for custom DataType (result must be less than Dispatcher TableSize)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::size_t DispatchKey(const DefaultDataType& obj){
+  return obj.empty() ? 0 : static_cast<unsigned char>(obj.front());
+}
+
+
+enum class DispatchMode_t { INLINE, WORKER };
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      class Dispatcher declaration
+      Classifies incoming parcels by DispatchKey() and calls handler registered for this key.
+      Handlers are kept in a table indexed by key, so classification is a single array lookup.
+      In WORKER mode parcels are queued per key and handled by a pool of workers_count threads. A key is taken
+      by one worker at a time, so order of parcels with the same key is preserved, and a slow handler for one key
+      occupies only one thread: handlers for other keys go on while fewer than workers_count keys are blocked.
+      Keys with pending parcels take turns, one parcel per turn.
+      Handlers must be registered before Start() / Dispatch() is called. Stop() stops worker threads, but keeps
+      handlers and their modes: Start() starts workers again, parcels for WORKER handlers are refused until then.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize = 256>
+class Dispatcher{
+
+public:
+  using Handler_t = std::function<void(const DataType&)>;
+
+private:
+  struct Entry{
+    Handler_t handler;
+    DispatchMode_t mode = DispatchMode_t::INLINE;
+    std::deque<DataType> queue;           //WORKER mode, guarded by pool_mutex_
+    bool scheduled = false;               //key is in ready_ or is being handled, guarded by pool_mutex_
+  };
+
+  std::array<Entry, TableSize> table_;
+  Handler_t default_handler_;
+
+  const std::size_t workers_count_;
+  std::vector<thread> workers_;
+  std::mutex pool_mutex_;
+  std::condition_variable pool_cv_;
+  std::deque<Entry*> ready_;              //keys with pending parcels, which no worker handles now
+  bool pool_running_ = false;             //guarded by pool_mutex_
+  bool pool_join_request_ = false;        //guarded by pool_mutex_
+
+  struct ThreadWrapper{
+    thread th;
+    atomic_bool join_request;
+  };
+  ThreadWrapper poll_thread_;
+
+private:
+  void WorkerLoop() noexcept;
+  void PollLoop(Board<DataType>& board, std::chrono::milliseconds idle_period) noexcept;
+  void StartWorkers();
+  void StopWorkers() noexcept;
+
+public:
+  //ctor / dtor
+  explicit Dispatcher(std::size_t workers_count = 4) : workers_count_(workers_count == 0 ? 1 : workers_count) {
+    poll_thread_.join_request.store(false, std::memory_order_relaxed);
+  }
+  Dispatcher(const Dispatcher& oth) = delete;
+  Dispatcher& operator=(const Dispatcher& oth) = delete;
+  virtual ~Dispatcher() { Stop(); }
+
+public:
+  //API
+  virtual bool Register(std::size_t key, Handler_t handler, DispatchMode_t mode = DispatchMode_t::INLINE);
+  virtual void RegisterDefault(Handler_t handler) { default_handler_ = std::move(handler); }   //for parcels without handler
+
+  virtual bool Dispatch(DataType data);   //returns false if there is no handler for parcel or its worker is stopped
+
+  //Starts thread, which pulls parcels from board.Receive() and dispatches them
+  virtual void Start(Board<DataType>& board, std::chrono::milliseconds idle_period = std::chrono::milliseconds(1));
+  virtual void Stop() noexcept;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Definitions of Dispatcher:: methods
+    --------------------------------------------------------------------------------------------------------------------
+*/
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::Register
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+bool Dispatcher<DataType, TableSize>::Register(std::size_t key, Handler_t handler, DispatchMode_t mode){
+  if(key >= TableSize || !handler)
+    return false;
+
+  Entry& entry = table_[key];
+  {
+    const std::lock_guard<std::mutex> lock(pool_mutex_);
+    if(entry.mode == DispatchMode_t::WORKER && pool_running_)
+      return false;     //workers may call handler of this key, replacing it is not safe
+  }
+
+  entry.handler = std::move(handler);
+  entry.mode = mode;
+  if(mode == DispatchMode_t::WORKER) {
+    StartWorkers();
+  }
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::StartWorkers
+        Pool is started once for all WORKER handlers
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+void Dispatcher<DataType, TableSize>::StartWorkers(){
+  const std::lock_guard<std::mutex> lock(pool_mutex_);
+  if(pool_running_)
+    return;
+  pool_join_request_ = false;
+  try{
+    workers_.reserve(workers_count_);
+    for(std::size_t i = 0; i < workers_count_; ++i) {
+      workers_.emplace_back(&Dispatcher<DataType, TableSize>::WorkerLoop, this);
+    }
+  }
+  catch(...){
+    if(workers_.empty())
+      throw;      //it's impossible to create a new thread
+  }
+  pool_running_ = true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::Dispatch
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+bool Dispatcher<DataType, TableSize>::Dispatch(DataType data){
+  const std::size_t key = DispatchKey(data);
+
+  if(key >= TableSize || !table_[key].handler) {
+    if(!default_handler_)
+      return false;
+    default_handler_(data);
+    return true;
+  }
+
+  Entry& entry = table_[key];
+  if(entry.mode == DispatchMode_t::INLINE) {
+    entry.handler(data);
+    return true;
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(pool_mutex_);
+    if(!pool_running_)
+      return false;     //workers are stopped, handler must not be called in thread of caller
+    entry.queue.push_back(std::move(data));
+    if(entry.scheduled)
+      return true;      //worker, which has the key, takes the parcel in turn
+    entry.scheduled = true;
+    ready_.push_back(&entry);
+  }
+  pool_cv_.notify_one();
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::Start
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+void Dispatcher<DataType, TableSize>::Start(Board<DataType>& board, std::chrono::milliseconds idle_period){
+  if(poll_thread_.th.joinable())
+    return;
+  poll_thread_.join_request.store(false, std::memory_order_relaxed);
+
+    //workers stopped by Stop()
+  if(std::any_of(table_.begin(), table_.end(), [](const Entry& entry){ return entry.mode == DispatchMode_t::WORKER; })) {
+    StartWorkers();
+  }
+
+  //exception may be thrown if's impossible to create a new thread
+  poll_thread_.th = thread{&Dispatcher<DataType, TableSize>::PollLoop, this, std::ref(board), idle_period};
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::Stop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+void Dispatcher<DataType, TableSize>::Stop() noexcept{
+  poll_thread_.join_request.store(true, std::memory_order_relaxed);
+  if(poll_thread_.th.joinable()) {
+    poll_thread_.th.join();
+  }
+  StopWorkers();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::StopWorkers
+        Workers finish remaining parcels of all keys before exit. Handlers and modes are kept for Start()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+void Dispatcher<DataType, TableSize>::StopWorkers() noexcept{
+  {
+    const std::lock_guard<std::mutex> lock(pool_mutex_);
+    pool_running_ = false;
+    pool_join_request_ = true;
+  }
+  pool_cv_.notify_all();
+  for(auto& worker : workers_) {
+    if(worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::PollLoop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+void Dispatcher<DataType, TableSize>::PollLoop(Board<DataType>& board, std::chrono::milliseconds idle_period) noexcept{
+  auto& stop_request_atomic = poll_thread_.join_request;
+  while(!stop_request_atomic.load(std::memory_order_relaxed)) {
+    try{
+      auto rx_data = board.Receive();
+      if(rx_data){
+        Dispatch(std::move(*rx_data));
+        continue;
+      }
+    }
+    catch(...){
+      cout<<"Error in dispatcher poll loop"<<endl;
+    }
+    std::this_thread::sleep_for(idle_period);
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+        Dispatcher::WorkerLoop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType, std::size_t TableSize>
+void Dispatcher<DataType, TableSize>::WorkerLoop() noexcept{
+  std::unique_lock<std::mutex> lock(pool_mutex_);
+  while(true) {
+    pool_cv_.wait(lock, [this]{ return pool_join_request_ || !ready_.empty(); });
+    if(ready_.empty())
+      break;    //join requested and nothing left
+
+    Entry& entry = *ready_.front();
+    ready_.pop_front();
+    DataType data = std::move(entry.queue.front());
+    entry.queue.pop_front();
+    lock.unlock();
+    try{
+      entry.handler(data);
+    }
+    catch(...){
+      cout<<"Error in dispatcher handler"<<endl;
+    }
+    lock.lock();
+
+      //key stays with no worker until the handler returns, then waits for its turn again
+    if(entry.queue.empty()) {
+      entry.scheduled = false;
+    }
+    else {
+      ready_.push_back(&entry);
+    }
+  }
+}
+
+
+}  //namespace board_connect
+
+#endif     //DISPATCHER_H
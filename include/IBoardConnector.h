@@ -9,28 +9,40 @@
 #ifndef I_BOARD_CONNECTOR_H
 #define I_BOARD_CONNECTOR_H
 
+#include <functional>
+
 #include "Declarations.h"
 #include "BoardConnectBuffer.h"
+#include "ParcelPool.h"
 
 namespace board_connect{
 
 template <typename DataType>
 class IBoardConnector{
-
+public:
+  using ReceiveTap_t = std::function<void(const TimestampedParcel<DataType>&)>;
 
 protected:
-  Buffer<DataType> send_buffer_;
-  Buffer<DataType> receive_buffer_;
+  Buffer<OutgoingParcel<DataType>> send_buffer_;
+  Buffer<TimestampedParcel<DataType>> receive_buffer_;
 
-  ConnectionStatus_t current_state_ = ConnectionStatus_t::UNDEFINED;
+  std::atomic<ConnectionStatus_t> current_state_{ConnectionStatus_t::UNDEFINED};     //read by Status() from any thread
+  ReceiveTap_t receive_tap_;
+
+    //every received parcel goes through here: tap sees it before it's queued for Receive()
+  void StoreReceived(TimestampedParcel<DataType>&& parcel) {
+    if(receive_tap_)
+      receive_tap_(parcel);
+    receive_buffer_.Store(std::move(parcel));
+  }
 
 //ctor / dtor  
 public:
   IBoardConnector() {};
   IBoardConnector(const IBoardConnector& oth) = delete;
-  IBoardConnector(IBoardConnector &&oth) = default;
-  IBoardConnector& operator=(const IBoardConnector& oth) = delete;
-  IBoardConnector& operator=(IBoardConnector&& oth) = default;
+  IBoardConnector(IBoardConnector &&oth) = delete;        //service threads keep pointer to connector: it's never moved,
+  IBoardConnector& operator=(const IBoardConnector& oth) = delete;    //Board moves only IBoardConnector_up
+  IBoardConnector& operator=(IBoardConnector&& oth) = delete;
   
   virtual ~IBoardConnector() = default;
   
@@ -40,8 +52,15 @@ public:
   virtual ConnectionStatus_t Status() = 0;
   virtual ConnectionStatus_t Disconnect() = 0;
   
-  virtual bool Send(const DataType data) = 0;
+  virtual bool Send(DataType data) = 0;                          //data is moved into parcel, pass rvalue to avoid copy
+  virtual bool SendShared(SharedParcel<DataType> parcel) = 0;    //enqueues parcel without copying it
+  virtual bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) = 0;    //only part of raw parcel
   virtual std::optional<DataType> Receive() = 0;
+  virtual std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() = 0;
+
+    //tap is called by connector's receiving thread for every parcel as it arrives, whether or not
+    //Receive() is ever called. Set it before Connect()
+  virtual void SetReceiveTap(ReceiveTap_t tap) { receive_tap_ = std::move(tap); }
 
 };
 
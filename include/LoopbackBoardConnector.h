@@ -0,0 +1,182 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  LoopbackBoardConnector header
+*/
+
+#ifndef LOOPBACK_BOARD_CONNECTOR_H
+#define LOOPBACK_BOARD_CONNECTOR_H
+
+#include "Declarations.h"
+#include "IBoardConnector.h"
+#include "MessageCodec.h"
+#include "LoopbackConnectionSettings.h"
+
+namespace board_connect {
+
+namespace loopback {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector
+      Connector to one end of LoopbackWire. Parcels are written into the wire on Send(), bytes are read from it
+      and assembled into parcels on Receive(), no service threads are needed. Used to test protocols
+      (e.g. reliable layer) without hardware: two connectors on two ends of a wire talk to each other.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class LoopbackBoardConnector : public IBoardConnector<DataType> {
+private:
+  const LoopbackConnectionSettings settings_;
+
+  mutex tx_mutex_;
+  std::vector<char> tx_scratch_;
+
+  mutex rx_mutex_;
+  codec::StreamDecoder<DataType> stream_decoder_;
+  std::vector<char> rx_buffer_;
+  std::mt19937 random_engine_{ std::random_device{}() };
+
+public:
+  LoopbackBoardConnector( const IConnectionSettings& settings)
+    : settings_(static_cast<const LoopbackConnectionSettings&>(settings)),
+      rx_buffer_(settings_.max_chunk_size > 0 ? settings_.max_chunk_size : 4096) {}
+
+  virtual ~LoopbackBoardConnector() = default;
+
+public:
+  ConnectionStatus_t Connect() override;
+  ConnectionStatus_t Status() noexcept override { return this->current_state_; }
+  ConnectionStatus_t Disconnect() noexcept override { return this->current_state_ = ConnectionStatus_t::DISCONNECTED_OK; }
+
+  bool Send(DataType data) override;
+  bool SendShared(SharedParcel<DataType> parcel) override;
+  bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) override;
+  std::optional<DataType> Receive() override;
+  std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() override;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnectorFactory
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class LoopbackBoardConnectorFactory : public IBoardConnectorFactory<DataType> {
+public:
+  ~LoopbackBoardConnectorFactory() override {}
+public:
+  IBoardConnector_up<DataType> MakeBoardConnector( const IConnectionSettings& connection_settings) const override {
+    return std::make_unique<LoopbackBoardConnector<DataType>>(connection_settings);
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector::Connect
+      Bytes written to this end while it was disconnected are dropped, as purge of port on connection
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t LoopbackBoardConnector<DataType>::Connect() {
+  if(!settings_.wire) {
+    return this->current_state_ = ConnectionStatus_t::CONNECTION_ERROR;
+  }
+  const lock_guard<mutex> lock(rx_mutex_);
+  settings_.wire->Purge(settings_.end);
+  stream_decoder_ = codec::StreamDecoder<DataType>();
+  return this->current_state_ = ConnectionStatus_t::CONNECTED_OK;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector::Send
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool LoopbackBoardConnector<DataType>::Send(DataType data) {
+  if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK)
+    return false;
+  const lock_guard<mutex> lock(tx_mutex_);
+  const std::string_view raw = codec::ToRaw(data, tx_scratch_);
+  settings_.wire->Write(settings_.end, raw.data(), raw.size());
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector::SendShared
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool LoopbackBoardConnector<DataType>::SendShared(SharedParcel<DataType> parcel) {
+  return SendSlice(std::move(parcel), 0, WHOLE_PARCEL);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector::SendSlice
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool LoopbackBoardConnector<DataType>::SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) {
+  if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK || !parcel)
+    return false;
+  const lock_guard<mutex> lock(tx_mutex_);
+  const std::string_view raw = codec::ToRaw(OutgoingParcel<DataType>{ std::move(parcel), offset, length }, tx_scratch_);
+  settings_.wire->Write(settings_.end, raw.data(), raw.size());
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector::Receive
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<DataType> LoopbackBoardConnector<DataType>::Receive() {
+  auto rx_data = ReceiveTimestamped();
+  if(rx_data == nullopt) {
+    return nullopt;
+  }
+  return std::move(rx_data->data);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackBoardConnector::ReceiveTimestamped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<TimestampedParcel<DataType>> LoopbackBoardConnector<DataType>::ReceiveTimestamped() {
+  if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK)
+    return nullopt;
+
+  const lock_guard<mutex> lock(rx_mutex_);
+  auto rx_data = this->receive_buffer_.Take();
+  if(rx_data)
+    return rx_data;
+
+  std::size_t read_size = rx_buffer_.size();
+  if(settings_.max_chunk_size > 0) {
+    read_size = std::uniform_int_distribution<std::size_t>(1, settings_.max_chunk_size)(random_engine_);
+  }
+  const std::size_t received = settings_.wire->Read(settings_.end, rx_buffer_.data(), read_size);
+  if(received == 0)
+    return nullopt;
+
+  const TimePoint_t timestamp = Clock_t::now();
+  stream_decoder_.Feed(rx_buffer_.data(), received, [this, timestamp](DataType&& data){
+    this->StoreReceived({ std::move(data), timestamp });
+  });
+  return this->receive_buffer_.Take();
+}
+
+
+}  //loopback
+
+}  //board_connect
+
+#endif  //LOOPBACK_BOARD_CONNECTOR_H
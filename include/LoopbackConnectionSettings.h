@@ -0,0 +1,89 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  LoopbackConnectionSettings header
+*/
+
+#ifndef LOOPBACK_CONNECTION_SETTINGS_H
+#define LOOPBACK_CONNECTION_SETTINGS_H
+
+#include <deque>
+#include <random>
+#include <algorithm>
+
+#include "Declarations.h"
+
+namespace board_connect {
+
+namespace loopback {
+
+
+enum LoopbackEnd_t { END_A = 0, END_B = 1 };
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackWire
+      In-memory byte stream between two ends, like a null-modem cable: bytes written by one end are read
+      by the other one. Data is not framed, reads return whatever has been written so far
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class LoopbackWire{
+
+  std::mutex wire_mutex_;
+  std::deque<char> queues_[2];        //bytes for END_A, bytes for END_B
+
+public:
+  void Write(LoopbackEnd_t from, const char* data, std::size_t size) {
+    const std::lock_guard<std::mutex> lock(wire_mutex_);
+    auto& queue = queues_[from == END_A ? END_B : END_A];
+    queue.insert(queue.end(), data, data + size);
+  }
+
+  std::size_t Read(LoopbackEnd_t to, char* dst, std::size_t max_size) {
+    const std::lock_guard<std::mutex> lock(wire_mutex_);
+    auto& queue = queues_[to];
+    const std::size_t size = std::min(max_size, queue.size());
+    std::copy(queue.begin(), queue.begin() + size, dst);
+    queue.erase(queue.begin(), queue.begin() + size);
+    return size;
+  }
+
+  void Purge(LoopbackEnd_t to) {
+    const std::lock_guard<std::mutex> lock(wire_mutex_);
+    queues_[to].clear();
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      LoopbackConnectionSettings
+      max_chunk_size - if not 0, every read returns random number of bytes up to it, as UART reads do
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct LoopbackConnectionSettings : IConnectionSettings {
+
+public:
+  const std::shared_ptr<LoopbackWire> wire;
+  const LoopbackEnd_t end;
+  std::size_t max_chunk_size = 0;
+
+public:
+  LoopbackConnectionSettings(std::shared_ptr<LoopbackWire> shared_wire, LoopbackEnd_t wire_end)
+    : wire(std::move(shared_wire)), end(wire_end) {}
+  virtual ~LoopbackConnectionSettings() = default;
+
+public:
+  void Dump() const override  {
+    cout<<"LoopbackEnd = "<<(end == END_A ? "A" : "B")<<endl;
+    cout<<"MaxChunkSize = "<<max_chunk_size<<endl;
+  };
+};
+
+
+}  //loopback
+
+}  //board_connect
+
+#endif  //LOOPBACK_CONNECTION_SETTINGS_H
@@ -0,0 +1,434 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  MessageCodec header
+
+  Fixed-size binary messages, described once by list of fields:
+
+    struct MyPacket { std::uint8_t id; std::int16_t value; float gain; };
+
+    BOARD_CONNECT_MESSAGE( MyPacket,
+                           board_connect::codec::Field<&MyPacket::id>,
+                           board_connect::codec::Field<&MyPacket::value, board_connect::codec::Endian_t::BIG>,
+                           board_connect::codec::Field<&MyPacket::gain> );
+
+    static_assert(board_connect::codec::MessageCodec<MyPacket>::SIZE == 7);
+
+  After this Board<MyPacket> sends packed messages and assembles received bytes into MyPacket,
+  no overloads of Data() are needed.
+
+  BOARD_CONNECT_MESSAGE has no framing: received stream is cut into messages by byte count only, so a lost
+  or extra byte shifts every following message. For links, which may lose bytes, use
+  BOARD_CONNECT_FRAMED_MESSAGE( MyPacket, 0x55AA, fields... ): each message is preceded by sync word and
+  followed by CRC-8, receiver skips bytes until it finds a valid frame.
+*/
+
+#ifndef MESSAGE_CODEC_H
+#define MESSAGE_CODEC_H
+
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include "Declarations.h"
+
+
+namespace board_connect {
+
+namespace codec {
+
+
+enum class Endian_t { LITTLE, BIG };
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+constexpr Endian_t HOST_ENDIAN = Endian_t::BIG;
+#else
+constexpr Endian_t HOST_ENDIAN = Endian_t::LITTLE;      //x86, x64 and ARM Windows targets
+#endif
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Field
+      MemberPtr - pointer to member (&MyPacket::value), member must be of arithmetic or enum type
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename T> struct MemberPointerTraits;
+
+template <typename Class, typename Member>
+struct MemberPointerTraits<Member Class::*> {
+  using Class_t = Class;
+  using Member_t = Member;
+};
+
+
+template <auto MemberPtr, Endian_t Endian = Endian_t::LITTLE>
+struct Field{
+  using Class_t = typename MemberPointerTraits<decltype(MemberPtr)>::Class_t;
+  using Member_t = typename MemberPointerTraits<decltype(MemberPtr)>::Member_t;
+
+  static constexpr auto POINTER = MemberPtr;
+  static constexpr Endian_t ENDIAN = Endian;
+  static constexpr std::size_t SIZE = sizeof(Member_t);
+
+  static_assert(std::is_arithmetic_v<Member_t> || std::is_enum_v<Member_t>, "Field must be of arithmetic or enum type");
+  static_assert(SIZE == 1 || SIZE == 2 || SIZE == 4 || SIZE == 8, "Field must be 1, 2, 4 or 8 bytes long");
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      MessageLayout
+      Specialized for user type by BOARD_CONNECT_MESSAGE macro
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename T>
+struct MessageLayout;
+
+template <typename T, typename = void>
+struct IsCodecMessage : std::false_type {};
+
+template <typename T>
+struct IsCodecMessage<T, std::void_t<typename MessageLayout<T>::Fields>> : std::true_type {};
+
+  //declared by BOARD_CONNECT_FRAMED_MESSAGE
+template <typename T, typename = void>
+struct IsFramedMessage : std::false_type {};
+
+template <typename T>
+struct IsFramedMessage<T, std::void_t<decltype(MessageLayout<T>::SYNC)>> : std::true_type {};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Byte order helpers
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <std::size_t Size> struct UnsignedOfSize;
+template <> struct UnsignedOfSize<1> { using Type = std::uint8_t; };
+template <> struct UnsignedOfSize<2> { using Type = std::uint16_t; };
+template <> struct UnsignedOfSize<4> { using Type = std::uint32_t; };
+template <> struct UnsignedOfSize<8> { using Type = std::uint64_t; };
+
+  //compilers turn this loop into single bswap instruction
+template <typename U>
+constexpr U ByteSwap(U value) noexcept {
+  U result = 0;
+  for(std::size_t i = 0; i < sizeof(U); ++i) {
+    result = static_cast<U>((result << 8) | (value & 0xFF));
+    value = static_cast<U>(value >> 8);
+  }
+  return result;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      MessageCodec
+      Pack / Unpack are unrolled at compile time into sequence of fixed-size copies (and byte swaps, where
+      field endianness differs from host). There are no loops or branches over fields at run time.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename T, typename FieldsTuple = typename MessageLayout<T>::Fields>
+struct MessageCodec;
+
+template <typename T, typename... Fields>
+struct MessageCodec<T, std::tuple<Fields...>> {
+
+  static_assert(sizeof...(Fields) > 0, "Message must have at least one field");
+  static_assert((std::is_same_v<typename Fields::Class_t, T> && ...), "All fields must be members of message type");
+  static_assert(std::is_default_constructible_v<T>, "Message type must be default constructible");
+
+  static constexpr std::size_t SIZE = (Fields::SIZE + ...);
+
+private:
+  template <typename F>
+  static void PackField(const T& obj, char* out) noexcept {
+    using Bits_t = typename UnsignedOfSize<F::SIZE>::Type;
+    Bits_t bits;
+    std::memcpy(&bits, &(obj.*F::POINTER), F::SIZE);
+    if constexpr (F::ENDIAN != HOST_ENDIAN) {
+      bits = ByteSwap(bits);
+    }
+    std::memcpy(out, &bits, F::SIZE);
+  }
+
+  template <typename F>
+  static void UnpackField(T& obj, const char* in) noexcept {
+    using Bits_t = typename UnsignedOfSize<F::SIZE>::Type;
+    Bits_t bits;
+    std::memcpy(&bits, in, F::SIZE);
+    if constexpr (F::ENDIAN != HOST_ENDIAN) {
+      bits = ByteSwap(bits);
+    }
+    std::memcpy(&(obj.*F::POINTER), &bits, F::SIZE);
+  }
+
+    //offset of field with given index
+  template <std::size_t Index>
+  static constexpr std::size_t Offset() {
+    constexpr std::size_t sizes[] = { Fields::SIZE... };
+    std::size_t offset = 0;
+    for(std::size_t i = 0; i < Index; ++i) {
+      offset += sizes[i];
+    }
+    return offset;
+  }
+
+  template <std::size_t... Indexes>
+  static void PackAll(const T& obj, char* out, std::index_sequence<Indexes...>) noexcept {
+    (PackField<Fields>(obj, out + Offset<Indexes>()), ...);
+  }
+
+  template <std::size_t... Indexes>
+  static void UnpackAll(T& obj, const char* in, std::index_sequence<Indexes...>) noexcept {
+    (UnpackField<Fields>(obj, in + Offset<Indexes>()), ...);
+  }
+
+public:
+  static void Pack(const T& obj, char* out) noexcept {      //out must have SIZE bytes
+    PackAll(obj, out, std::index_sequence_for<Fields...>{});
+  }
+
+  static T Unpack(const char* in) noexcept {                //in must have SIZE bytes
+    T obj{};
+    UnpackAll(obj, in, std::index_sequence_for<Fields...>{});
+    return obj;
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Framed messages
+        SYNC (2 bytes, little-endian) | message (MessageCodec::SIZE) | CRC-8 of message (1)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+constexpr std::size_t FRAME_SYNC_SIZE = 2;
+constexpr std::size_t FRAME_CHECK_SIZE = 1;
+
+  //CRC-8, polynomial 0x07. Table is built at compile time: receiver checks CRC at every byte while it hunts for sync
+struct Crc8Table{
+  std::uint8_t values[256];
+
+  constexpr Crc8Table() : values{} {
+    for(unsigned i = 0; i < 256; ++i) {
+      unsigned crc = i;
+      for(int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) & 0xFF : (crc << 1) & 0xFF;
+      }
+      values[i] = static_cast<std::uint8_t>(crc);
+    }
+  }
+};
+
+inline constexpr Crc8Table CRC8_TABLE{};
+
+inline std::uint8_t Crc8(const char* data, std::size_t size) noexcept {
+  std::uint8_t crc = 0;
+  for(std::size_t i = 0; i < size; ++i) {
+    crc = CRC8_TABLE.values[crc ^ static_cast<std::uint8_t>(data[i])];
+  }
+  return crc;
+}
+
+  //bytes of one message on the wire
+template <typename DataType>
+constexpr std::size_t WireSize() {
+  if constexpr (IsFramedMessage<DataType>::value)
+    return FRAME_SYNC_SIZE + MessageCodec<DataType>::SIZE + FRAME_CHECK_SIZE;
+  else
+    return MessageCodec<DataType>::SIZE;
+}
+
+template <typename DataType>
+void PackFrame(const DataType& obj, char* out) noexcept {       //out must have WireSize() bytes
+  constexpr std::uint16_t sync = MessageLayout<DataType>::SYNC;
+  out[0] = static_cast<char>(sync & 0xFF);
+  out[1] = static_cast<char>(sync >> 8);
+  MessageCodec<DataType>::Pack(obj, out + FRAME_SYNC_SIZE);
+  out[FRAME_SYNC_SIZE + MessageCodec<DataType>::SIZE] = static_cast<char>(Crc8(out + FRAME_SYNC_SIZE, MessageCodec<DataType>::SIZE));
+}
+
+template <typename DataType>
+bool IsValidFrame(const char* in) noexcept {                    //in must have WireSize() bytes
+  constexpr std::uint16_t sync = MessageLayout<DataType>::SYNC;
+  return static_cast<unsigned char>(in[0]) == (sync & 0xFF) && static_cast<unsigned char>(in[1]) == (sync >> 8)
+      && static_cast<std::uint8_t>(in[FRAME_SYNC_SIZE + MessageCodec<DataType>::SIZE]) == Crc8(in + FRAME_SYNC_SIZE, MessageCodec<DataType>::SIZE);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Conversion of DataType to raw bytes and back, used by connectors
+      codec messages - packed by MessageCodec, std::string - as is, other types - by user overloads of Data()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+std::string_view ToRaw(const DataType& obj, std::vector<char>& scratch) {
+  if constexpr (IsFramedMessage<DataType>::value) {
+    scratch.resize(WireSize<DataType>());
+    PackFrame(obj, scratch.data());
+    return std::string_view(scratch.data(), scratch.size());
+  }
+  else if constexpr (IsCodecMessage<DataType>::value) {
+    scratch.resize(MessageCodec<DataType>::SIZE);
+    MessageCodec<DataType>::Pack(obj, scratch.data());
+    return std::string_view(scratch.data(), scratch.size());
+  }
+  else if constexpr (std::is_same_v<DataType, DefaultDataType>) {
+    return std::string_view(obj.data(), obj.size());
+  }
+  else {
+    const char* raw_str = Data(obj);
+    return std::string_view(raw_str, std::strlen(raw_str));
+  }
+}
+
+
+  //part of parcel to be sent, see OutgoingParcel. Range is clipped to size of raw parcel
+template <typename DataType>
+std::string_view ToRaw(const OutgoingParcel<DataType>& outgoing, std::vector<char>& scratch) {
+  const std::string_view raw = ToRaw(*outgoing.parcel, scratch);
+  const std::size_t offset = std::min(outgoing.offset, raw.size());
+  return raw.substr(offset, std::min(outgoing.length, raw.size() - offset));
+}
+
+
+  //one whole message (e.g. a slot of shared memory ring). nullopt if size does not match codec message
+template <typename DataType>
+std::optional<DataType> FromRaw(const char* raw, std::size_t size) {
+  if constexpr (IsFramedMessage<DataType>::value) {
+    if(size != WireSize<DataType>() || !IsValidFrame<DataType>(raw))
+      return std::nullopt;
+    return MessageCodec<DataType>::Unpack(raw + FRAME_SYNC_SIZE);
+  }
+  else if constexpr (IsCodecMessage<DataType>::value) {
+    if(size != MessageCodec<DataType>::SIZE)
+      return std::nullopt;
+    return MessageCodec<DataType>::Unpack(raw);
+  }
+  else {
+    return Data(const_cast<char*>(raw), static_cast<int>(size));
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      StreamDecoder
+      Turns chunks of byte stream into DataType objects. For codec messages chunks are assembled into
+      messages of MessageCodec::SIZE bytes (incomplete message is kept until next chunk),
+      for other types every chunk is converted by Data().
+      Stream of framed messages is searched for valid frames: bytes, which don't start one (noise, part of
+      message received before connection), are skipped and counted, so decoder resyncs after lost byte.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class StreamDecoder{
+
+  std::vector<char> pending_;
+  std::uint64_t skipped_bytes_ = 0;
+
+private:
+    //frames are decoded in place, only bytes of incomplete frame are kept in pending_ (less than frame size)
+  template <typename Callback>
+  void FeedFrames(const char* raw, std::size_t size, Callback& on_message) {
+    constexpr std::size_t frame_size = WireSize<DataType>();
+    std::size_t pos = 0;
+    if(!pending_.empty()) {
+        //frame starting in pending bytes ends in the first frame_size - 1 bytes of chunk
+      const std::size_t pending_size = pending_.size();
+      pending_.insert(pending_.end(), raw, raw + std::min(size, frame_size - 1));
+      std::size_t start = 0;
+      while(start < pending_size && pending_.size() - start >= frame_size) {
+        if(IsValidFrame<DataType>(pending_.data() + start)) {
+          on_message(MessageCodec<DataType>::Unpack(pending_.data() + start + FRAME_SYNC_SIZE));
+          start += frame_size;
+        }
+        else {
+          ++start;
+          ++skipped_bytes_;
+        }
+      }
+      if(start < pending_size) {
+          //whole chunk is in pending_ and it's still too short
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(start));
+        return;
+      }
+      pos = start - pending_size;
+    }
+    while(size - pos >= frame_size) {
+      if(IsValidFrame<DataType>(raw + pos)) {
+        on_message(MessageCodec<DataType>::Unpack(raw + pos + FRAME_SYNC_SIZE));
+        pos += frame_size;
+      }
+      else {
+        ++pos;
+        ++skipped_bytes_;
+      }
+    }
+    pending_.assign(raw + pos, raw + size);
+  }
+
+public:
+  std::uint64_t SkippedBytes() const { return skipped_bytes_; }
+
+  template <typename Callback>
+  void Feed(const char* raw, std::size_t size, Callback&& on_message) {
+    if constexpr (IsFramedMessage<DataType>::value) {
+      FeedFrames(raw, size, on_message);
+    }
+    else if constexpr (IsCodecMessage<DataType>::value) {
+      constexpr std::size_t message_size = MessageCodec<DataType>::SIZE;
+      if(!pending_.empty()) {
+        const std::size_t taken = std::min(message_size - pending_.size(), size);
+        pending_.insert(pending_.end(), raw, raw + taken);
+        raw += taken;
+        size -= taken;
+        if(pending_.size() < message_size)
+          return;
+        on_message(MessageCodec<DataType>::Unpack(pending_.data()));
+        pending_.clear();
+      }
+      for(; size >= message_size; raw += message_size, size -= message_size) {
+        on_message(MessageCodec<DataType>::Unpack(raw));
+      }
+      pending_.assign(raw, raw + size);
+    }
+    else {
+      on_message(Data(const_cast<char*>(raw), static_cast<int>(size)));
+    }
+  }
+};
+
+
+}  //codec
+
+}  //board_connect
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      BOARD_CONNECT_MESSAGE(Type, Field<...>, ...)
+      Must be used at global namespace scope. Messages are sent back to back without framing: receiver can't
+      find start of message again after a lost or extra byte, see BOARD_CONNECT_FRAMED_MESSAGE
+    --------------------------------------------------------------------------------------------------------------------
+*/
+#define BOARD_CONNECT_MESSAGE(Type, ...)                    \
+  template <>                                                \
+  struct board_connect::codec::MessageLayout<Type> {          \
+    using Fields = std::tuple<__VA_ARGS__>;                  \
+  };
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      BOARD_CONNECT_FRAMED_MESSAGE(Type, SyncWord, Field<...>, ...)
+      The same message with 16-bit sync word before it and CRC-8 after it (3 bytes of overhead)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+#define BOARD_CONNECT_FRAMED_MESSAGE(Type, SyncWord, ...)   \
+  template <>                                                \
+  struct board_connect::codec::MessageLayout<Type> {          \
+    using Fields = std::tuple<__VA_ARGS__>;                  \
+    static constexpr std::uint16_t SYNC = SyncWord;          \
+  };
+
+#endif  //MESSAGE_CODEC_H
@@ -0,0 +1,187 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Pacer header
+*/
+
+#ifndef PACER_H
+#define PACER_H
+
+#include <algorithm>
+
+#include "Declarations.h"
+
+
+namespace board_connect {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      TokenBucket
+      rate tokens per second are added to bucket, up to burst tokens. Amount larger than burst is allowed
+      when bucket is full and leaves bucket in debt, so long-term rate is kept for any parcel size.
+      rate <= 0 means no limit.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class TokenBucket{
+
+  const double rate_;
+  const double burst_;
+  double tokens_;
+  TimePoint_t last_refill_;
+
+private:
+  void Refill(TimePoint_t now) {
+    const std::chrono::duration<double> elapsed = now - last_refill_;
+    tokens_ = std::min(burst_, tokens_ + elapsed.count() * rate_);
+    last_refill_ = now;
+  }
+
+public:
+  TokenBucket(double rate, double burst)
+    : rate_(rate), burst_(std::max(burst, 1.0)), tokens_(std::max(burst, 1.0)), last_refill_(Clock_t::now()) {}
+
+  bool Unlimited() const { return rate_ <= 0; }
+
+    //time to wait before amount may be consumed
+  Clock_t::duration Delay(double amount, TimePoint_t now) {
+    if(Unlimited())
+      return Clock_t::duration::zero();
+    Refill(now);
+    const double required = std::min(amount, burst_);
+    if(tokens_ >= required)
+      return Clock_t::duration::zero();
+    return std::chrono::duration_cast<Clock_t::duration>(std::chrono::duration<double>((required - tokens_) / rate_));
+  }
+
+  void Consume(double amount) {
+    if(!Unlimited())
+      tokens_ -= amount;
+  }
+
+    //full bucket, debt of previous traffic is forgotten
+  void Reset(TimePoint_t now) {
+    tokens_ = burst_;
+    last_refill_ = now;
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Pacer
+      Limits outgoing traffic both in bytes/s and in parcels/s. Waits on high resolution waitable timer,
+      which gives sub-millisecond precision, unlike Sleep() with its default 15.6 ms granularity.
+      Wait is interrupted by stop event (e.g. Disconnect()), so even very low rate does not delay stopping
+      of sender. Not thread-safe: it's used by one sender thread, Reset() is called while sender is stopped.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class Pacer{
+
+  TokenBucket bytes_bucket_;
+  TokenBucket parcels_bucket_;
+  Handler timer_ = nullptr;
+
+private:
+  bool WaitFor(Clock_t::duration delay, Handler stop_event) noexcept;
+
+public:
+  Pacer(double bytes_per_second, double bytes_burst, double parcels_per_second, double parcels_burst);
+  Pacer(const Pacer& oth) = delete;
+  Pacer& operator=(const Pacer& oth) = delete;
+  virtual ~Pacer() { if(timer_ != nullptr) CloseHandle(timer_); }
+
+public:
+    //blocks until parcel of given size may be sent, then accounts it. false if stop_event is set before that,
+    //parcel is not accounted then
+  bool Wait(std::size_t bytes, Handler stop_event = nullptr) noexcept;
+  void Reset() noexcept;      //new connection starts with full buckets
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Pacer:: constructor
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline Pacer::Pacer(double bytes_per_second, double bytes_burst, double parcels_per_second, double parcels_burst)
+  : bytes_bucket_(bytes_per_second, bytes_burst), parcels_bucket_(parcels_per_second, parcels_burst) {
+  if(bytes_bucket_.Unlimited() && parcels_bucket_.Unlimited())
+    return;
+
+  //high resolution timers are available since Windows 10 1803, fall back to ordinary one
+  timer_ = CreateWaitableTimerExA(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+  if(timer_ == nullptr) {
+    timer_ = CreateWaitableTimerA(nullptr, TRUE, nullptr);
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Pacer::Wait
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool Pacer::Wait(std::size_t bytes, Handler stop_event) noexcept {
+  if(bytes_bucket_.Unlimited() && parcels_bucket_.Unlimited())
+    return true;
+
+  while(true) {
+    const TimePoint_t now = Clock_t::now();
+    const Clock_t::duration delay = std::max(bytes_bucket_.Delay(bytes, now), parcels_bucket_.Delay(1, now));
+    if(delay <= Clock_t::duration::zero())
+      break;
+    if(!WaitFor(delay, stop_event))
+      return false;
+  }
+  bytes_bucket_.Consume(bytes);
+  parcels_bucket_.Consume(1);
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Pacer::Reset
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void Pacer::Reset() noexcept {
+  const TimePoint_t now = Clock_t::now();
+  bytes_bucket_.Reset(now);
+  parcels_bucket_.Reset(now);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Pacer::WaitFor
+      false if stop_event is set during waiting
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool Pacer::WaitFor(Clock_t::duration delay, Handler stop_event) noexcept {
+  if(timer_ != nullptr) {
+    //relative due time is negative, in 100 ns units
+    LARGE_INTEGER due_time;
+    due_time.QuadPart = -std::max<long long>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count() / 100);
+    if(SetWaitableTimer(timer_, &due_time, 0, nullptr, nullptr, FALSE)) {
+      if(stop_event == nullptr) {
+        WaitForSingleObject(timer_, INFINITE);
+        return true;
+      }
+      const Handler events[] = { timer_, stop_event };
+      const DWORD result = WaitForMultipleObjects(2, events, FALSE, INFINITE);
+      if(result == WAIT_OBJECT_0)
+        return true;
+      CancelWaitableTimer(timer_);
+      return false;
+    }
+  }
+  if(stop_event == nullptr) {
+    std::this_thread::sleep_for(delay);
+    return true;
+  }
+    //no timer: millisecond wait on stop event, rounded up
+  const auto delay_ms = std::chrono::ceil<std::chrono::milliseconds>(delay);
+  return WaitForSingleObject(stop_event, static_cast<DWORD>(delay_ms.count())) == WAIT_TIMEOUT;
+}
+
+
+}  //board_connect
+
+#endif  //PACER_H
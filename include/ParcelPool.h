@@ -0,0 +1,116 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  ParcelPool header
+*/
+
+#ifndef PARCEL_POOL_H
+#define PARCEL_POOL_H
+
+#include <vector>
+
+#include "Declarations.h"
+
+
+namespace board_connect {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      BlockPool
+      Free list of memory blocks for objects of type T. Released blocks are kept for reuse (up to MAX_FREE_BLOCKS),
+      so steady flow of parcels does not touch the heap.
+      One pool per type for the whole program. It's never destroyed: parcels may outlive static objects.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename T>
+class BlockPool{
+
+  constexpr static std::size_t MAX_FREE_BLOCKS = 1024;
+
+  std::mutex pool_mutex_;
+  std::vector<T*> free_blocks_;
+
+private:
+  BlockPool() { free_blocks_.reserve(MAX_FREE_BLOCKS); }
+
+public:
+  BlockPool(const BlockPool& oth) = delete;
+  BlockPool& operator=(const BlockPool& oth) = delete;
+
+  static BlockPool& Instance() {
+    static BlockPool* pool = new BlockPool;
+    return *pool;
+  }
+
+  T* Allocate() {
+    {
+      const std::lock_guard<std::mutex> lock(pool_mutex_);
+      if(!free_blocks_.empty()) {
+        T* block = free_blocks_.back();
+        free_blocks_.pop_back();
+        return block;
+      }
+    }
+    return std::allocator<T>().allocate(1);
+  }
+
+  void Deallocate(T* block) noexcept {
+    {
+      const std::lock_guard<std::mutex> lock(pool_mutex_);
+      if(free_blocks_.size() < MAX_FREE_BLOCKS) {
+        free_blocks_.push_back(block);      //capacity is reserved, no allocation here
+        return;
+      }
+    }
+    std::allocator<T>().deallocate(block, 1);
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ParcelAllocator
+      Stateless allocator over BlockPool. Used by std::allocate_shared, which rebinds it to type of control block
+      with parcel inside, so each parcel costs one block from the pool.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename T>
+struct ParcelAllocator{
+  using value_type = T;
+
+  ParcelAllocator() = default;
+  template <typename U>
+  ParcelAllocator(const ParcelAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t count) {
+    if(count != 1)
+      return std::allocator<T>().allocate(count);
+    return BlockPool<T>::Instance().Allocate();
+  }
+
+  void deallocate(T* block, std::size_t count) noexcept {
+    if(count != 1) {
+      std::allocator<T>().deallocate(block, count);
+      return;
+    }
+    BlockPool<T>::Instance().Deallocate(block);
+  }
+
+  template <typename U>
+  bool operator==(const ParcelAllocator<U>&) const noexcept { return true; }
+  template <typename U>
+  bool operator!=(const ParcelAllocator<U>&) const noexcept { return false; }
+};
+
+
+  //constructs parcel in place from args (e.g. moved payload). Memory is taken from pool
+template <typename DataType, typename... Args>
+SharedParcel<DataType> MakeParcel(Args&&... args) {
+  return std::allocate_shared<const DataType>(ParcelAllocator<DataType>(), std::forward<Args>(args)...);
+}
+
+
+}  //board_connect
+
+#endif  //PARCEL_POOL_H
@@ -0,0 +1,151 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  PublishingBoardConnector header
+*/
+
+#ifndef PUBLISHING_BOARD_CONNECTOR_H
+#define PUBLISHING_BOARD_CONNECTOR_H
+
+#include <vector>
+
+#include "Declarations.h"
+#include "IBoardConnector.h"
+#include "SharedMemoryConnectionSettings.h"
+#include "SharedMemoryRing.h"
+#include "MessageCodec.h"
+
+namespace board_connect {
+
+namespace shared_memory {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      PublishingBoardConnector
+      Decorator over connector to a board (e.g. UART): every parcel received from it is also written into named
+      shared memory ring, other processes read it with SharedMemoryBoardConnector. Parcels are published by receive
+      tap of inner connector as they arrive, so readers get them even if owner never calls Receive().
+      Sending is passed through.
+      Ring is created by the first Connect() and kept until connector is destroyed, so readers stay attached
+      while the board is reconnected. Parcels larger than slot_size are counted by DroppedCount().
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class PublishingBoardConnector : public IBoardConnector<DataType> {
+private:
+  const PublishingConnectionSettings settings_;
+  IBoardConnector_up<DataType> inner_;
+
+  mutex publish_mutex_;
+  std::unique_ptr<SharedMemoryPublisher> publisher_;     //guarded by publish_mutex_
+  std::vector<char> publish_scratch_;
+
+private:
+  void Publish(const TimestampedParcel<DataType>& parcel) noexcept;
+
+public:
+  PublishingBoardConnector( const IConnectionSettings& settings, IBoardConnector_up<DataType> inner )
+    : settings_(static_cast<const PublishingConnectionSettings&>(settings)), inner_(std::move(inner)) {
+    inner_->SetReceiveTap([this](const TimestampedParcel<DataType>& parcel){
+      Publish(parcel);
+      if(this->receive_tap_)
+        this->receive_tap_(parcel);
+    });
+  }
+
+  virtual ~PublishingBoardConnector() { inner_.reset(); }      //stops receiving thread, which calls Publish()
+
+public:
+  ConnectionStatus_t Connect() override;
+  ConnectionStatus_t Status() noexcept override { return inner_->Status(); }
+  ConnectionStatus_t Disconnect() noexcept override { return inner_->Disconnect(); }
+
+  bool Send(DataType data) override { return inner_->Send(std::move(data)); }
+  bool SendShared(SharedParcel<DataType> parcel) override { return inner_->SendShared(std::move(parcel)); }
+  bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) override {
+    return inner_->SendSlice(std::move(parcel), offset, length);
+  }
+  std::optional<DataType> Receive() override { return inner_->Receive(); }
+  std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() override { return inner_->ReceiveTimestamped(); }
+
+  std::uint64_t DroppedCount() {
+    const lock_guard<mutex> lock(publish_mutex_);
+    return publisher_ ? publisher_->DroppedCount() : 0;
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      PublishingBoardConnectorFactory
+      Board connector is created by inner_factory with inner_settings (e.g. UART).
+      Both references are used only in MakeBoardConnector()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class PublishingBoardConnectorFactory : public IBoardConnectorFactory<DataType> {
+  const IConnectionSettings& inner_settings_;
+  const IBoardConnectorFactory<DataType>& inner_factory_;
+
+public:
+  PublishingBoardConnectorFactory(  const IConnectionSettings& inner_settings,
+                                    const IBoardConnectorFactory<DataType>& inner_factory )
+    : inner_settings_(inner_settings), inner_factory_(inner_factory) {}
+  ~PublishingBoardConnectorFactory() override {}
+
+public:
+  IBoardConnector_up<DataType> MakeBoardConnector( const IConnectionSettings& connection_settings) const override {
+    return std::make_unique<PublishingBoardConnector<DataType>>(connection_settings, inner_factory_.MakeBoardConnector(inner_settings_));
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      PublishingBoardConnector::Connect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t PublishingBoardConnector<DataType>::Connect() {
+  {
+    const lock_guard<mutex> lock(publish_mutex_);
+    if(!publisher_) {
+      try{
+        publisher_ = std::make_unique<SharedMemoryPublisher>(settings_.name, settings_.slot_count, settings_.slot_size);
+      }
+      catch(const std::exception& ex){
+        cout<<"Unable to create shared memory ring "<<settings_.name<<": "<<ex.what()<<endl;
+        return this->current_state_ = ConnectionStatus_t::CONNECTION_ERROR;
+      }
+    }
+  }
+  return this->current_state_ = inner_->Connect();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      PublishingBoardConnector::Publish
+      Runs on receiving thread of inner connector.
+      Oversized parcel is counted in ring header by SharedMemoryPublisher::Publish()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void PublishingBoardConnector<DataType>::Publish(const TimestampedParcel<DataType>& parcel) noexcept {
+  const lock_guard<mutex> lock(publish_mutex_);
+  if(!publisher_)
+    return;
+  try{
+    const std::string_view raw = codec::ToRaw(parcel.data, publish_scratch_);
+    publisher_->Publish(raw.data(), raw.size(), parcel.timestamp);
+  }
+  catch(...){
+    cout<<"Error in publishing of parcel"<<endl;
+  }
+}
+
+
+} //shared_memory
+
+}  //board_connect
+
+#endif  //PUBLISHING_BOARD_CONNECTOR_H
@@ -0,0 +1,863 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  ReliableBoardConnector header
+*/
+
+#ifndef RELIABLE_BOARD_CONNECTOR_H
+#define RELIABLE_BOARD_CONNECTOR_H
+
+#include <map>
+#include <deque>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+
+#include "Declarations.h"
+#include "IBoardConnector.h"
+#include "MessageCodec.h"
+#include "ReliableConnectionSettings.h"
+
+namespace board_connect {
+
+namespace reliable {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Frame format (all numbers little-endian)
+        SYNC (0xA5) | type (1) | epoch (1) | seq (2) | length (2) | header check (1) | payload (length) | CRC16 (2)
+      header check - low byte of CRC16 of type..length, so damaged length does not stall the parser
+      CRC16 (CCITT) covers type..payload
+
+      Each direction of the link is numbered independently. Epoch identifies incarnation of sending side:
+      it's changed on every Connect(), so frames of previous connection are never taken for current ones.
+      SYN frame:     epoch - new epoch of sender, seq - initial sequence number (ISN). Repeated by timeout
+      SYN_ACK frame: epoch and seq of SYN being confirmed. Sender starts sending DATA only after it,
+                     receiver accepts DATA only of the epoch of the last SYN
+      DATA frame:    epoch of sender, seq - sequence number of parcel, payload - parcel
+      ACK frame:     epoch of DATA being acknowledged, seq - next expected sequence number (cumulative ACK),
+                     payload - 4 bytes bitmap, bit i is set if parcel seq + 1 + i is received (selective ACK)
+      RESET frame:   answer to DATA of unknown epoch (e.g. receiver has been restarted), epoch of that DATA.
+                     Sender repeats SYN and sends unacknowledged parcels again
+    --------------------------------------------------------------------------------------------------------------------
+*/
+constexpr unsigned char FRAME_SYNC = 0xA5;
+constexpr std::size_t FRAME_HEADER_SIZE = 8;
+constexpr std::size_t FRAME_CRC_SIZE = 2;
+
+enum FrameType_t : unsigned char { FRAME_DATA = 1, FRAME_ACK = 2, FRAME_SYN = 3, FRAME_SYN_ACK = 4, FRAME_RESET = 5 };
+
+struct Frame{
+  FrameType_t type;
+  std::uint8_t epoch;
+  std::uint16_t seq;
+  std::string payload;
+};
+
+
+inline std::uint16_t Crc16(const char* data, std::size_t size) noexcept {
+  std::uint16_t crc = 0xFFFF;
+  for(std::size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<std::uint16_t>(static_cast<unsigned char>(data[i]) << 8);
+    for(int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021) : static_cast<std::uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+
+inline std::string EncodeFrame(FrameType_t type, std::uint8_t epoch, std::uint16_t seq, std::string_view payload) {
+  std::string frame;
+  frame.reserve(FRAME_HEADER_SIZE + payload.size() + FRAME_CRC_SIZE);
+  frame.push_back(static_cast<char>(FRAME_SYNC));
+  frame.push_back(static_cast<char>(type));
+  frame.push_back(static_cast<char>(epoch));
+  frame.push_back(static_cast<char>(seq & 0xFF));
+  frame.push_back(static_cast<char>(seq >> 8));
+  frame.push_back(static_cast<char>(payload.size() & 0xFF));
+  frame.push_back(static_cast<char>(payload.size() >> 8));
+  frame.push_back(static_cast<char>(Crc16(frame.data() + 1, FRAME_HEADER_SIZE - 2) & 0xFF));
+  frame.append(payload.data(), payload.size());
+  const std::uint16_t crc = Crc16(frame.data() + 1, frame.size() - 1);
+  frame.push_back(static_cast<char>(crc & 0xFF));
+  frame.push_back(static_cast<char>(crc >> 8));
+  return frame;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      FrameParser
+      Finds frames in byte stream. Damaged frames are dropped, parser resynchronizes on the next SYNC byte.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class FrameParser{
+
+  const std::size_t max_payload_size_;
+  std::string pending_;
+  std::uint64_t damaged_count_ = 0;
+
+public:
+  explicit FrameParser(std::size_t max_payload_size) : max_payload_size_(max_payload_size) {}
+
+  std::uint64_t DamagedCount() const { return damaged_count_; }
+
+  template <typename Callback>
+  void Feed(const char* raw, std::size_t size, Callback&& on_frame) {
+    pending_.append(raw, size);
+    std::size_t pos = 0;
+
+    while(true) {
+      pos = pending_.find(static_cast<char>(FRAME_SYNC), pos);
+      if(pos == std::string::npos) {
+        pending_.clear();
+        return;
+      }
+      if(pending_.size() - pos < FRAME_HEADER_SIZE)
+        break;
+
+      const unsigned char* header = reinterpret_cast<const unsigned char*>(pending_.data() + pos);
+      const std::size_t length = header[5] | (header[6] << 8);
+      if(   header[7] != (Crc16(pending_.data() + pos + 1, FRAME_HEADER_SIZE - 2) & 0xFF)
+         || length > max_payload_size_ || header[1] < FRAME_DATA || header[1] > FRAME_RESET) {
+        ++damaged_count_;
+        ++pos;        //not a frame start
+        continue;
+      }
+      const std::size_t frame_size = FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE;
+      if(pending_.size() - pos < frame_size)
+        break;
+
+      const std::uint16_t crc = static_cast<std::uint16_t>(  static_cast<unsigned char>(pending_[pos + frame_size - 2])
+                                                          | static_cast<unsigned char>(pending_[pos + frame_size - 1]) << 8 );
+      if(crc != Crc16(pending_.data() + pos + 1, frame_size - 1 - FRAME_CRC_SIZE)) {
+        ++damaged_count_;
+        ++pos;
+        continue;
+      }
+
+      on_frame(Frame{ static_cast<FrameType_t>(header[1]),
+                      header[2],
+                      static_cast<std::uint16_t>(header[3] | (header[4] << 8)),
+                      pending_.substr(pos + FRAME_HEADER_SIZE, length) });
+      pos += frame_size;
+    }
+    pending_.erase(0, pos);
+  }
+};
+
+
+  //signed distance between 16-bit sequence numbers
+inline int SeqDistance(std::uint16_t from, std::uint16_t to) noexcept {
+  return static_cast<std::int16_t>(static_cast<std::uint16_t>(to - from));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector
+      Reliability layer between Board and any byte-stream connector (link). Parcels are numbered and sent
+      in a sliding window, receiver confirms them with cumulative and selective ACKs, unconfirmed parcels
+      are retransmitted after adaptive timeout (RTO estimated from RTT as in TCP, RFC 6298).
+      Received parcels are delivered in order and without duplicates.
+      After Connect() parcels are queued until peer confirms SYN. If peer is restarted, parcels, which were not
+      acknowledged by it, are sent to its new incarnation again (so they may be delivered twice across restart).
+      All protocol work is done in a single service thread.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class ReliableBoardConnector : public IBoardConnector<DataType> {
+private:
+  const ReliableConnectionSettings settings_;
+  IBoardConnector_up<DefaultDataType> link_;
+
+  struct InFlight{
+    std::uint16_t seq;
+    SharedParcel<DefaultDataType> frame;      //shared with send queue of link, retransmits do not copy it
+    TimePoint_t sent_at;
+    int retransmits = 0;
+    bool acked = false;
+  };
+
+  struct Received{
+    std::string payload;
+    TimePoint_t timestamp;
+  };
+
+  std::mt19937 random_engine_{ std::random_device{}() };
+
+    //sender side
+  std::uint8_t local_epoch_;
+  bool send_synced_ = false;            //SYN of local_epoch_ is confirmed by peer
+  std::uint16_t send_isn_ = 0;
+  TimePoint_t syn_sent_at_;
+  int syn_retransmits_ = 0;
+  std::deque<InFlight> in_flight_;
+  std::uint16_t next_send_seq_ = 0;
+  Clock_t::duration srtt_{0};
+  Clock_t::duration rttvar_{0};
+  Clock_t::duration rto_;
+  bool rtt_measured_ = false;
+
+    //receiver side
+  std::uint8_t peer_epoch_ = 0;         //0 - no SYN received yet
+  std::uint16_t peer_isn_ = 0;
+  std::uint16_t next_receive_seq_ = 0;
+  std::map<std::uint16_t, Received> out_of_order_;      //parcels received ahead of next_receive_seq_
+  FrameParser parser_;
+  bool ack_required_ = false;
+
+  std::vector<char> tx_scratch_;
+
+  atomic_bool link_lost_flag_;
+  mutex lifecycle_mutex_;        //Connect() and Disconnect() may be called from different threads
+
+  struct ThreadWrapper{
+    thread th;
+    atomic_bool join_request;
+  };
+  ThreadWrapper service_thread_;
+
+private:
+  void ServiceLoop() noexcept;
+  bool ProcessIncoming();
+  bool FillWindow();
+  bool RetransmitExpired();
+  void OnFrame(Frame&& frame, TimePoint_t timestamp);
+  void OnData(Frame&& frame, TimePoint_t timestamp);
+  void OnAck(const Frame& frame);
+  void OnSyn(const Frame& frame);
+  void OnSynAck(const Frame& frame);
+  void SendAck();
+  void StartSync(TimePoint_t now);
+  void SendFrame(const SharedParcel<DefaultDataType>& frame);
+  bool Retransmit(InFlight& parcel, TimePoint_t now);
+  void UpdateRto(Clock_t::duration rtt);
+  void RestoreRto();
+  void ResetProtocolState();
+  ConnectionStatus_t DisconnectUnlocked() noexcept;
+
+public:
+  ReliableBoardConnector( const IConnectionSettings& settings, IBoardConnector_up<DefaultDataType> link );
+  virtual ~ReliableBoardConnector() { Disconnect(); }
+
+public:
+  ConnectionStatus_t Connect() override;
+  ConnectionStatus_t Status() noexcept override;
+  ConnectionStatus_t Disconnect() noexcept override;
+
+  bool Send(DataType data) override;
+  bool SendShared(SharedParcel<DataType> parcel) override;
+  bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) override;
+  std::optional<DataType> Receive() override;
+  std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() override;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnectorFactory
+      Link connector is created by link_factory with link_settings (e.g. UART).
+      Both references are used only in MakeBoardConnector()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class ReliableBoardConnectorFactory : public IBoardConnectorFactory<DataType> {
+  const IConnectionSettings& link_settings_;
+  const IBoardConnectorFactory<DefaultDataType>& link_factory_;
+
+public:
+  ReliableBoardConnectorFactory(  const IConnectionSettings& link_settings,
+                                  const IBoardConnectorFactory<DefaultDataType>& link_factory )
+    : link_settings_(link_settings), link_factory_(link_factory) {}
+  ~ReliableBoardConnectorFactory() override {}
+
+public:
+  IBoardConnector_up<DataType> MakeBoardConnector( const IConnectionSettings& connection_settings) const override {
+    return std::make_unique<ReliableBoardConnector<DataType>>(connection_settings, link_factory_.MakeBoardConnector(link_settings_));
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector:: constructor
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ReliableBoardConnector<DataType>::ReliableBoardConnector( const IConnectionSettings& settings, IBoardConnector_up<DefaultDataType> link )
+  : settings_(static_cast<const ReliableConnectionSettings&>(settings)),
+    link_(std::move(link)),
+    local_epoch_(static_cast<std::uint8_t>(std::uniform_int_distribution<int>(1, 255)(random_engine_))),
+    rto_(settings_.initial_rto),
+    parser_(static_cast<std::size_t>(std::clamp(settings_.max_payload_size, 4, 65535))) {
+  link_lost_flag_.store(false, std::memory_order_relaxed);
+  service_thread_.join_request.store(false, std::memory_order_relaxed);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::Connect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t ReliableBoardConnector<DataType>::Connect() {
+  const lock_guard<mutex> lock(lifecycle_mutex_);
+  DisconnectUnlocked();
+  this->current_state_ = ConnectionStatus_t::CONNECTION_IN_PROGRESS;
+
+  const ConnectionStatus_t link_status = link_->Connect();
+  if(link_status != ConnectionStatus_t::CONNECTED_OK) {
+    return this->current_state_ = link_status;
+  }
+
+  ResetProtocolState();
+  try {
+    service_thread_.join_request.store(false, std::memory_order_relaxed);
+    service_thread_.th = thread{&ReliableBoardConnector<DataType>::ServiceLoop, this};
+  }
+  catch(std::exception& err) {
+    link_->Disconnect();
+    cout<<"Unable to start reliable link service. Connection cancelled"<<endl;
+    return this->current_state_ = ConnectionStatus_t::OTHER_ERROR;
+  }
+  return this->current_state_ = ConnectionStatus_t::CONNECTED_OK;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::Status
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t ReliableBoardConnector<DataType>::Status() noexcept {
+  ConnectionStatus_t expected = ConnectionStatus_t::CONNECTED_OK;
+  if(this->current_state_ == expected) {
+    const ConnectionStatus_t link_status = link_lost_flag_.load(std::memory_order_relaxed) ? ConnectionStatus_t::CONNECTION_LOST 
+                                                                                            : link_->Status();
+      //state is not overwritten, if Disconnect() has changed it meanwhile
+    if(link_status != ConnectionStatus_t::CONNECTED_OK) {
+      this->current_state_.compare_exchange_strong(expected, link_status);
+    }
+  }
+  return this->current_state_;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::Disconnect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t ReliableBoardConnector<DataType>::Disconnect() noexcept {
+  const lock_guard<mutex> lock(lifecycle_mutex_);
+  return DisconnectUnlocked();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::DisconnectUnlocked
+      lifecycle_mutex_ must be locked by caller
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t ReliableBoardConnector<DataType>::DisconnectUnlocked() noexcept {
+  this->current_state_ = ConnectionStatus_t::DISCONNECTION_IN_PROGRESS;
+  service_thread_.join_request.store(true, std::memory_order_relaxed);
+  if(service_thread_.th.joinable()) {
+    service_thread_.th.join();
+  }
+  link_->Disconnect();
+  return this->current_state_ = ConnectionStatus_t::DISCONNECTED_OK;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::Send
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::Send(DataType data) {
+  if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK)
+    return false;
+  return SendShared(MakeParcel<DataType>(std::move(data)));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::SendShared
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::SendShared(SharedParcel<DataType> parcel) {
+  return SendSlice(std::move(parcel), 0, WHOLE_PARCEL);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::SendSlice
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) {
+  if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK || !parcel)
+    return false;
+  return this->send_buffer_.Store({ std::move(parcel), offset, length });
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::Receive
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<DataType> ReliableBoardConnector<DataType>::Receive() {
+  auto rx_data = ReceiveTimestamped();
+  if(rx_data == nullopt) {
+    return nullopt;
+  }
+  return std::move(rx_data->data);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::ReceiveTimestamped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<TimestampedParcel<DataType>> ReliableBoardConnector<DataType>::ReceiveTimestamped() {
+  return this->receive_buffer_.Take();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::ResetProtocolState
+      New epoch and random ISN, so that peer does not take frames of this connection for frames of previous one.
+      Receiver side waits for SYN of peer
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::ResetProtocolState() {
+  in_flight_.clear();
+  next_send_seq_ = static_cast<std::uint16_t>(std::uniform_int_distribution<int>(0, 65535)(random_engine_));
+  rtt_measured_ = false;
+  rto_ = settings_.initial_rto;
+  peer_epoch_ = 0;
+  next_receive_seq_ = 0;
+  out_of_order_.clear();
+  ack_required_ = false;
+  link_lost_flag_.store(false, std::memory_order_relaxed);
+  StartSync(Clock_t::now());
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::StartSync
+      Sends SYN of the next epoch. Unacknowledged parcels are renumbered from ISN into this epoch
+      and sent again after SYN_ACK
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::StartSync(TimePoint_t now) {
+  local_epoch_ = (local_epoch_ == 255) ? 1 : local_epoch_ + 1;       //0 is reserved for "no epoch"
+  send_isn_ = in_flight_.empty() ? next_send_seq_ : in_flight_.front().seq;
+  for(auto& parcel : in_flight_) {
+    const std::string_view payload(parcel.frame->data() + FRAME_HEADER_SIZE, parcel.frame->size() - FRAME_HEADER_SIZE - FRAME_CRC_SIZE);
+    parcel.frame = MakeParcel<DefaultDataType>(EncodeFrame(FRAME_DATA, local_epoch_, parcel.seq, payload));
+    parcel.acked = false;       //selective ACKs of previous incarnation of peer are void
+    parcel.retransmits = 0;
+  }
+  send_synced_ = false;
+  syn_retransmits_ = 0;
+  syn_sent_at_ = now;
+  SendFrame(MakeParcel<DefaultDataType>(EncodeFrame(FRAME_SYN, local_epoch_, send_isn_, {})));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::ServiceLoop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::ServiceLoop() noexcept {
+  auto& stop_request_atomic = service_thread_.join_request;
+  while(!stop_request_atomic.load(std::memory_order_relaxed)) {
+    bool busy = false;
+    try{
+      busy |= ProcessIncoming();
+      if(!link_lost_flag_.load(std::memory_order_relaxed)) {
+        busy |= RetransmitExpired();
+        busy |= FillWindow();
+      }
+    }
+    catch(...){
+      cout<<"Error in reliable link service loop"<<endl;
+    }
+    if(!busy) {
+      std::this_thread::sleep_for(settings_.service_period);
+    }
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::ProcessIncoming
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::ProcessIncoming() {
+  bool received = false;
+  while(auto chunk = link_->ReceiveTimestamped()) {
+    received = true;
+    const TimePoint_t timestamp = chunk->timestamp;
+    parser_.Feed(chunk->data.data(), chunk->data.size(), [this, timestamp](Frame&& frame){
+      OnFrame(std::move(frame), timestamp);
+    });
+  }
+  if(ack_required_) {
+    SendAck();
+  }
+  return received;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::OnFrame
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::OnFrame(Frame&& frame, TimePoint_t timestamp) {
+  switch(frame.type) {
+  case FRAME_DATA:
+    OnData(std::move(frame), timestamp);
+    break;
+  case FRAME_ACK:
+    OnAck(frame);
+    break;
+  case FRAME_SYN:
+    OnSyn(frame);
+    break;
+  case FRAME_SYN_ACK:
+    OnSynAck(frame);
+    break;
+  case FRAME_RESET:
+      //peer does not know current epoch (it has been restarted and missed our SYN)
+    if(send_synced_ && frame.epoch == local_epoch_) {
+      StartSync(Clock_t::now());
+    }
+    break;
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::OnSyn
+      SYN with new epoch or ISN starts new incarnation of peer's direction. Repeated SYN is only confirmed again
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::OnSyn(const Frame& frame) {
+  if(frame.epoch == 0)
+    return;
+  if(frame.epoch != peer_epoch_ || frame.seq != peer_isn_) {
+    peer_epoch_ = frame.epoch;
+    peer_isn_ = frame.seq;
+    next_receive_seq_ = frame.seq;
+    out_of_order_.clear();
+    ack_required_ = false;
+  }
+  SendFrame(MakeParcel<DefaultDataType>(EncodeFrame(FRAME_SYN_ACK, frame.epoch, frame.seq, {})));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::OnSynAck
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::OnSynAck(const Frame& frame) {
+  if(send_synced_ || frame.epoch != local_epoch_ || frame.seq != send_isn_)
+    return;     //confirmation of previous SYN or repeated one
+
+  const TimePoint_t now = Clock_t::now();
+  send_synced_ = true;
+  if(syn_retransmits_ == 0) {
+    UpdateRto(now - syn_sent_at_);
+  }
+  else {
+    RestoreRto();
+  }
+
+    //parcels left from previous epoch
+  for(auto& parcel : in_flight_) {
+    SendFrame(parcel.frame);
+    parcel.sent_at = now;
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::OnData
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::OnData(Frame&& frame, TimePoint_t timestamp) {
+  if(peer_epoch_ == 0 || frame.epoch != peer_epoch_) {
+      //DATA of previous connection or of peer, which does not know that we have been restarted
+    SendFrame(MakeParcel<DefaultDataType>(EncodeFrame(FRAME_RESET, frame.epoch, frame.seq, {})));
+    return;
+  }
+  ack_required_ = true;     //duplicates are acknowledged too, previous ACK may be lost
+
+  const int distance = SeqDistance(next_receive_seq_, frame.seq);
+  if(distance < 0 || distance >= ReliableConnectionSettings::MAX_WINDOW_SIZE)
+    return;     //duplicate or out of window
+
+  out_of_order_.emplace(frame.seq, Received{ std::move(frame.payload), timestamp });
+
+    //deliver all consecutive parcels, each with time of its own arrival
+  for(auto next = out_of_order_.find(next_receive_seq_); next != out_of_order_.end(); next = out_of_order_.find(next_receive_seq_)) {
+    auto rx_data = codec::FromRaw<DataType>(next->second.payload.data(), next->second.payload.size());
+    if(rx_data) {
+      this->StoreReceived({ std::move(*rx_data), next->second.timestamp });
+    }
+    out_of_order_.erase(next);
+    ++next_receive_seq_;
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::SendAck
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::SendAck() {
+  std::uint32_t bitmap = 0;
+  for(const auto& item : out_of_order_) {
+    const int distance = SeqDistance(next_receive_seq_, item.first);
+    if(distance >= 1 && distance <= 32) {
+      bitmap |= 1u << (distance - 1);
+    }
+  }
+  const char payload[4] = { static_cast<char>(bitmap & 0xFF),         static_cast<char>((bitmap >> 8) & 0xFF),
+                            static_cast<char>((bitmap >> 16) & 0xFF), static_cast<char>((bitmap >> 24) & 0xFF) };
+  SendFrame(MakeParcel<DefaultDataType>(EncodeFrame(FRAME_ACK, peer_epoch_, next_receive_seq_, std::string_view(payload, sizeof(payload)))));
+  ack_required_ = false;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::OnAck
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::OnAck(const Frame& frame) {
+  if(!send_synced_ || frame.epoch != local_epoch_ || frame.payload.size() != 4)
+    return;     //ACK of previous epoch
+  const unsigned char* raw = reinterpret_cast<const unsigned char*>(frame.payload.data());
+  const std::uint32_t bitmap = raw[0] | (raw[1] << 8) | (raw[2] << 16) | (static_cast<std::uint32_t>(raw[3]) << 24);
+
+  const TimePoint_t now = Clock_t::now();
+  bool window_advanced = false;
+  int last_selective = -1;          //index in in_flight_ of the newest selectively acknowledged parcel
+  for(std::size_t i = 0; i < in_flight_.size(); ++i) {
+    InFlight& parcel = in_flight_[i];
+    const int distance = SeqDistance(frame.seq, parcel.seq);
+    const bool cumulative = distance < 0;
+    const bool selective = distance >= 1 && distance <= 32 && (bitmap & (1u << (distance - 1)));
+    if(selective) {
+      last_selective = static_cast<int>(i);
+    }
+    if(parcel.acked || !(cumulative || selective))
+      continue;
+
+    parcel.acked = true;
+    window_advanced |= cumulative;
+    if(parcel.retransmits == 0) {     //Karn's algorithm: RTT of retransmitted parcel is ambiguous
+      UpdateRto(now - parcel.sent_at);
+    }
+  }
+
+    //parcels are delivered again, exponential backoff is not needed anymore
+  if(window_advanced) {
+    RestoreRto();
+  }
+
+    //fast retransmit: newer parcel has arrived, so older unacknowledged one is lost (link keeps order).
+    //Parcel sent less than one RTT ago may still be on the way
+  for(int i = 0; i < last_selective; ++i) {
+    InFlight& parcel = in_flight_[static_cast<std::size_t>(i)];
+    if(!parcel.acked && now - parcel.sent_at >= srtt_) {
+      if(!Retransmit(parcel, now))
+        return;
+    }
+  }
+
+  while(!in_flight_.empty() && in_flight_.front().acked) {
+    in_flight_.pop_front();
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::Retransmit
+      false if parcel has exhausted its retransmits, link is considered lost then
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::Retransmit(InFlight& parcel, TimePoint_t now) {
+  if(parcel.retransmits >= settings_.max_retransmits) {
+    cout<<"Parcel is not acknowledged after "<<parcel.retransmits<<" retransmits. Connection lost"<<endl;
+    link_lost_flag_.store(true, std::memory_order_relaxed);
+    return false;
+  }
+  SendFrame(parcel.frame);
+  parcel.sent_at = now;
+  ++parcel.retransmits;
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::UpdateRto
+      RFC 6298: SRTT, RTTVAR and RTO = SRTT + 4 * RTTVAR
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::UpdateRto(Clock_t::duration rtt) {
+  if(!rtt_measured_) {
+    srtt_ = rtt;
+    rttvar_ = rtt / 2;
+    rtt_measured_ = true;
+  }
+  else {
+    const Clock_t::duration deviation = (srtt_ > rtt) ? (srtt_ - rtt) : (rtt - srtt_);
+    rttvar_ = (3 * rttvar_ + deviation) / 4;
+    srtt_ = (7 * srtt_ + rtt) / 8;
+  }
+  RestoreRto();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::RestoreRto
+      Drops exponential backoff
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::RestoreRto() {
+  if(!rtt_measured_) {
+    rto_ = settings_.initial_rto;
+    return;
+  }
+  const Clock_t::duration min_rto = settings_.min_rto;
+  const Clock_t::duration max_rto = settings_.max_rto;
+  rto_ = std::clamp(srtt_ + 4 * rttvar_, min_rto, max_rto);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::RetransmitExpired
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::RetransmitExpired() {
+  bool retransmitted = false;
+  const TimePoint_t now = Clock_t::now();
+  if(!send_synced_) {
+      //SYN is retransmitted as any parcel, unacknowledged DATA waits for SYN_ACK
+    if(now - syn_sent_at_ >= rto_) {
+      if(syn_retransmits_ >= settings_.max_retransmits) {
+        cout<<"SYN is not confirmed after "<<syn_retransmits_<<" retransmits. Connection lost"<<endl;
+        link_lost_flag_.store(true, std::memory_order_relaxed);
+        return false;
+      }
+      SendFrame(MakeParcel<DefaultDataType>(EncodeFrame(FRAME_SYN, local_epoch_, send_isn_, {})));
+      syn_sent_at_ = now;
+      ++syn_retransmits_;
+      retransmitted = true;
+    }
+  }
+  else {
+    for(auto& parcel : in_flight_) {
+      if(parcel.acked || now - parcel.sent_at < rto_)
+        continue;
+
+      if(!Retransmit(parcel, now))
+        return retransmitted;
+      retransmitted = true;
+    }
+  }
+
+    //exponential backoff, once per timeout event. RTO is restored by next RTT measurement
+  if(retransmitted) {
+    const Clock_t::duration max_rto = settings_.max_rto;
+    rto_ = std::min(rto_ * 2, max_rto);
+  }
+  return retransmitted;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::FillWindow
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool ReliableBoardConnector<DataType>::FillWindow() {
+  const std::size_t window_size = static_cast<std::size_t>(std::clamp(settings_.window_size, 1, ReliableConnectionSettings::MAX_WINDOW_SIZE));
+  bool sent = false;
+  if(!send_synced_)
+    return sent;      //parcels wait in send queue until peer confirms SYN
+
+  while(in_flight_.size() < window_size) {
+    auto send_parcel = this->send_buffer_.Load();
+    if(!send_parcel)
+      break;
+
+    const std::string_view payload = codec::ToRaw(*send_parcel, tx_scratch_);
+    this->send_buffer_.ConfirmReception();
+    if(payload.size() > static_cast<std::size_t>(settings_.max_payload_size) || payload.size() > 65535) {
+      cout<<"Parcel is larger than max_payload_size, dropped"<<endl;
+      continue;
+    }
+
+    InFlight parcel;
+    parcel.seq = next_send_seq_++;
+    parcel.frame = MakeParcel<DefaultDataType>(EncodeFrame(FRAME_DATA, local_epoch_, parcel.seq, payload));
+    parcel.sent_at = Clock_t::now();
+    SendFrame(parcel.frame);
+    in_flight_.push_back(std::move(parcel));
+    sent = true;
+  }
+  return sent;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableBoardConnector::SendFrame
+      Applies fault injection, if enabled
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void ReliableBoardConnector<DataType>::SendFrame(const SharedParcel<DefaultDataType>& frame) {
+  if(settings_.inject_loss_probability > 0 || settings_.inject_corruption_probability > 0) {
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    if(chance(random_engine_) < settings_.inject_loss_probability)
+      return;
+    if(chance(random_engine_) < settings_.inject_corruption_probability) {
+      std::string corrupted = *frame;
+      std::uniform_int_distribution<std::size_t> position(0, corrupted.size() - 1);
+      corrupted[position(random_engine_)] ^= static_cast<char>(1 << std::uniform_int_distribution<int>(0, 7)(random_engine_));
+      link_->Send(std::move(corrupted));
+      return;
+    }
+  }
+  link_->SendShared(frame);
+}
+
+
+} //reliable
+
+}  //board_connect
+
+#endif  //RELIABLE_BOARD_CONNECTOR_H
@@ -0,0 +1,73 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  ReliableConnectionSettings header
+*/
+
+#ifndef RELIABLE_CONNECTION_SETTINGS_H
+#define RELIABLE_CONNECTION_SETTINGS_H
+
+#include "Declarations.h"
+
+namespace board_connect {
+
+namespace reliable {
+
+using Duration_t = std::chrono::duration<long long, std::milli>;
+using std::chrono::operator""ms;
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ReliableConnectionSettings
+      Parameters of sliding window protocol of ReliableBoardConnector.
+      Board must run the same protocol (see frame format in ReliableBoardConnector.h)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct ReliableConnectionSettings : IConnectionSettings {
+
+public:
+  constexpr static int MAX_WINDOW_SIZE = 32;           //limited by width of selective ACK bitmap
+
+protected:
+  constexpr static int DEFAULT_WINDOW_SIZE = 8;
+  constexpr static Duration_t DEFAULT_INITIAL_RTO = 200ms;
+  constexpr static Duration_t DEFAULT_MIN_RTO = 10ms;
+  constexpr static Duration_t DEFAULT_MAX_RTO = 2000ms;
+  constexpr static int DEFAULT_MAX_RETRANSMITS = 10;
+  constexpr static int DEFAULT_MAX_PAYLOAD_SIZE = 1024;
+  constexpr static Duration_t DEFAULT_SERVICE_PERIOD = 1ms;
+
+public:
+  int window_size = DEFAULT_WINDOW_SIZE;               //parcels sent, but not acknowledged yet. 1..MAX_WINDOW_SIZE
+  Duration_t initial_rto = DEFAULT_INITIAL_RTO;        //retransmission timeout before first RTT measurement
+  Duration_t min_rto = DEFAULT_MIN_RTO;
+  Duration_t max_rto = DEFAULT_MAX_RTO;
+  int max_retransmits = DEFAULT_MAX_RETRANSMITS;       //after this parcel is considered undeliverable, connection is lost
+  int max_payload_size = DEFAULT_MAX_PAYLOAD_SIZE;     //bytes, up to 65535
+  Duration_t service_period = DEFAULT_SERVICE_PERIOD;  //idle period of service loop
+
+    //fault injection for outgoing frames, 0..1. For testing on real or loopback links
+  double inject_loss_probability = 0;
+  double inject_corruption_probability = 0;
+
+public:
+  ReliableConnectionSettings() = default;
+  virtual ~ReliableConnectionSettings() = default;
+
+public:
+  void Dump() const override  {
+    cout<<"WindowSize = "<<window_size<<endl;
+    cout<<"InitialRTO = "<<initial_rto.count()<<" ms"<<endl;
+    cout<<"MaxRetransmits = "<<max_retransmits<<endl;
+    cout<<"MaxPayloadSize = "<<max_payload_size<<endl;
+  };
+};
+
+
+}  //reliable
+
+}  //board_connect
+
+#endif  //RELIABLE_CONNECTION_SETTINGS_H
@@ -0,0 +1,346 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  class SampleFrameDecoder
+
+*/
+
+#ifndef SAMPLE_FRAME_DECODER_H
+#define SAMPLE_FRAME_DECODER_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#include "Declarations.h"
+#include "Board.h"
+
+//#define BOARD_CONNECT_NO_SIMD      //uncomment to use scalar kernels only
+
+#if !defined(BOARD_CONNECT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define BOARD_CONNECT_SSE2
+  #include <emmintrin.h>
+#endif
+
+
+namespace board_connect{
+
+
+enum class SampleFormat_t { INT16_LE = 2, INT24_LE = 3 };     //value is size of one sample in bytes
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Conversion kernels
+      Convert count little-endian samples into float, multiplying by scale.
+      Deinterleave moves frames_count frames of channels_count samples into channel rows: channel ch is written
+      to dst + ch * dst_stride. *Scalar versions are reference for SSE2 ones and handle their tails
+    --------------------------------------------------------------------------------------------------------------------
+*/
+namespace kernels{
+
+inline void Int16ToFloatScalar(const unsigned char* src, float* dst, std::size_t count, float scale) noexcept {
+  for(std::size_t i = 0; i < count; ++i) {
+    const std::int16_t sample = static_cast<std::int16_t>(src[2 * i] | (src[2 * i + 1] << 8));
+    dst[i] = sample * scale;
+  }
+}
+
+
+inline void Int16ToFloat(const unsigned char* src, float* dst, std::size_t count, float scale) noexcept {
+  std::size_t i = 0;
+#ifdef BOARD_CONNECT_SSE2
+  const __m128 scale_v = _mm_set1_ps(scale);
+  for(; i + 8 <= count; i += 8) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+      //sign extension: place int16 into high half of int32 and shift back
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+    _mm_storeu_ps(dst + i,     _mm_mul_ps(_mm_cvtepi32_ps(lo), scale_v));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale_v));
+  }
+#endif
+  Int16ToFloatScalar(src + 2 * i, dst + i, count - i, scale);
+}
+
+
+  //places 24-bit little-endian sample into high bits of 32-bit word
+inline std::int32_t Int24High(const unsigned char* s) noexcept {
+  return static_cast<std::int32_t>(  static_cast<std::uint32_t>(s[0]) << 8
+                                   | static_cast<std::uint32_t>(s[1]) << 16
+                                   | static_cast<std::uint32_t>(s[2]) << 24 );
+}
+
+
+inline void Int24ToFloatScalar(const unsigned char* src, float* dst, std::size_t count, float scale) noexcept {
+  for(std::size_t i = 0; i < count; ++i) {
+    dst[i] = (Int24High(src + 3 * i) >> 8) * scale;
+  }
+}
+
+
+inline void Int24ToFloat(const unsigned char* src, float* dst, std::size_t count, float scale) noexcept {
+  std::size_t i = 0;
+#ifdef BOARD_CONNECT_SSE2
+  const __m128 scale_v = _mm_set1_ps(scale);
+  for(; i + 4 <= count; i += 4) {
+    const unsigned char* s = src + 3 * i;
+      //exactly 12 bytes of 4 samples are loaded, then sample k is shifted to bytes 0..2 of lane k
+    std::int32_t tail;
+    std::memcpy(&tail, s + 8, sizeof(tail));
+    const __m128i bytes = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s)), _mm_cvtsi32_si128(tail));
+    const __m128i lanes = _mm_unpacklo_epi64(_mm_unpacklo_epi32(bytes, _mm_srli_si128(bytes, 3)),
+                                             _mm_unpacklo_epi32(_mm_srli_si128(bytes, 6), _mm_srli_si128(bytes, 9)));
+      //each sample is placed into high 24 bits of int32, arithmetic shift restores the sign
+    const __m128i raw = _mm_slli_epi32(lanes, 8);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(raw, 8)), scale_v));
+  }
+#endif
+  Int24ToFloatScalar(src + 3 * i, dst + i, count - i, scale);
+}
+
+
+inline void DeinterleaveScalar(const float* src, std::size_t channels_count, std::size_t frames_count,
+                               float* dst, std::size_t dst_stride) noexcept {
+  for(std::size_t ch = 0; ch < channels_count; ++ch) {
+    float* row = dst + ch * dst_stride;
+    const float* column = src + ch;
+    for(std::size_t f = 0; f < frames_count; ++f) {
+      row[f] = column[f * channels_count];
+    }
+  }
+}
+
+
+  //2, 4 and 8 channels are transposed by blocks of 4 frames, other counts use scalar loop
+inline void Deinterleave(const float* src, std::size_t channels_count, std::size_t frames_count,
+                         float* dst, std::size_t dst_stride) noexcept {
+  std::size_t f = 0;
+#ifdef BOARD_CONNECT_SSE2
+  if(channels_count == 2) {
+    for(; f + 4 <= frames_count; f += 4) {
+      const __m128 a = _mm_loadu_ps(src + 2 * f);
+      const __m128 b = _mm_loadu_ps(src + 2 * f + 4);
+      _mm_storeu_ps(dst + f,              _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(dst + dst_stride + f, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+  }
+  else if(channels_count == 4 || channels_count == 8) {
+    for(; f + 4 <= frames_count; f += 4) {
+      for(std::size_t block = 0; block < channels_count; block += 4) {
+        const float* s = src + f * channels_count + block;
+        __m128 row0 = _mm_loadu_ps(s);
+        __m128 row1 = _mm_loadu_ps(s + channels_count);
+        __m128 row2 = _mm_loadu_ps(s + 2 * channels_count);
+        __m128 row3 = _mm_loadu_ps(s + 3 * channels_count);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        float* d = dst + block * dst_stride + f;
+        _mm_storeu_ps(d,                  row0);
+        _mm_storeu_ps(d + dst_stride,     row1);
+        _mm_storeu_ps(d + 2 * dst_stride, row2);
+        _mm_storeu_ps(d + 3 * dst_stride, row3);
+      }
+    }
+  }
+#endif
+  DeinterleaveScalar(src + f * channels_count, channels_count, frames_count - f, dst + f, dst_stride);
+}
+
+}  //kernels
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      class SampleFrameDecoder declaration
+      Decodes stream of fixed-layout frames (channels_count interleaved samples per frame) into
+      per-channel ring buffers of float (structure of arrays). Stream may be fed in chunks of any size,
+      incomplete frame is kept until the rest of it arrives.
+      When ring buffer is full, the oldest samples are overwritten.
+      Feed() / Poll() are expected to be called from one thread, Read() / Consume() may be called from another.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class SampleFrameDecoder{
+
+  const std::size_t channels_count_;
+  const SampleFormat_t format_;
+  const std::size_t capacity_;          //samples per channel
+  const float scale_;
+
+  std::mutex rings_mutex_;
+  std::vector<float> rings_;            //channels_count_ rings of capacity_ samples, one after another
+  std::size_t write_pos_ = 0;           //common for all channels
+  std::size_t available_ = 0;
+
+  std::vector<unsigned char> pending_;  //incomplete frame from previous chunk
+  std::vector<float> scratch_;          //converted, but still interleaved samples
+
+private:
+  std::size_t FrameSize() const { return channels_count_ * static_cast<std::size_t>(format_); }
+  void DecodeFrames(const unsigned char* src, std::size_t frames_count);
+
+public:
+  //ctor / dtor
+  SampleFrameDecoder( std::size_t channels_count,
+                      SampleFormat_t format = SampleFormat_t::INT16_LE,
+                      std::size_t capacity = 4096,
+                      float scale = 1.0f );
+  SampleFrameDecoder(const SampleFrameDecoder& oth) = delete;
+  SampleFrameDecoder& operator=(const SampleFrameDecoder& oth) = delete;
+  virtual ~SampleFrameDecoder() = default;
+
+public:
+  //API
+  void Feed(const char* raw, std::size_t size);
+  void Feed(const DefaultDataType& chunk) { Feed(chunk.data(), chunk.size()); }
+  std::size_t Poll(Board<DefaultDataType>& board);     //feeds everything received by board, returns number of bytes fed
+
+  std::size_t Available();                             //samples available in each channel
+  std::size_t Read(std::size_t channel, float* dst, std::size_t max_count);   //does not remove samples
+  void Consume(std::size_t count);                     //removes count oldest samples from all channels
+
+  std::size_t ChannelsCount() const { return channels_count_; }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder:: constructor
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline SampleFrameDecoder::SampleFrameDecoder( std::size_t channels_count,
+                                              SampleFormat_t format,
+                                              std::size_t capacity,
+                                              float scale )
+  : channels_count_(channels_count), format_(format), capacity_(capacity), scale_(scale) {
+  if(channels_count_ == 0 || capacity_ == 0) {
+    throw std::invalid_argument("SampleFrameDecoder: channels count and capacity must be positive");
+  }
+  rings_.resize(channels_count_ * capacity_);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder::Feed
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void SampleFrameDecoder::Feed(const char* raw, std::size_t size) {
+  const unsigned char* src = reinterpret_cast<const unsigned char*>(raw);
+  const std::size_t frame_size = FrameSize();
+
+    //complete frame, started in previous chunk
+  if(!pending_.empty()) {
+    const std::size_t missing = frame_size - pending_.size();
+    const std::size_t taken = std::min(missing, size);
+    pending_.insert(pending_.end(), src, src + taken);
+    src += taken;
+    size -= taken;
+    if(pending_.size() < frame_size)
+      return;
+    DecodeFrames(pending_.data(), 1);
+    pending_.clear();
+  }
+
+  const std::size_t frames_count = size / frame_size;
+  if(frames_count > 0) {
+    DecodeFrames(src, frames_count);
+  }
+  pending_.assign(src + frames_count * frame_size, src + size);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder::DecodeFrames
+      Converts whole block at once, then de-interleaves it into rings by runs, which do not cross end of ring
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void SampleFrameDecoder::DecodeFrames(const unsigned char* src, std::size_t frames_count) {
+  const std::size_t samples_count = frames_count * channels_count_;
+  scratch_.resize(samples_count);
+
+  switch(format_) {
+  case SampleFormat_t::INT16_LE:
+    kernels::Int16ToFloat(src, scratch_.data(), samples_count, scale_);
+    break;
+  case SampleFormat_t::INT24_LE:
+    kernels::Int24ToFloat(src, scratch_.data(), samples_count, scale_);
+    break;
+  }
+
+    //only the last capacity_ frames may survive in rings
+  std::size_t first_frame = 0;
+  if(frames_count > capacity_) {
+    first_frame = frames_count - capacity_;
+  }
+
+  const std::lock_guard<std::mutex> lock(rings_mutex_);
+  std::size_t pos = (write_pos_ + first_frame) % capacity_;
+  for(std::size_t f = first_frame; f < frames_count; ) {
+    const std::size_t run = std::min(frames_count - f, capacity_ - pos);
+    kernels::Deinterleave(scratch_.data() + f * channels_count_, channels_count_, run, rings_.data() + pos, capacity_);
+    f += run;
+    pos = (pos + run) % capacity_;
+  }
+  write_pos_ = (write_pos_ + frames_count) % capacity_;
+  available_ = std::min(capacity_, available_ + frames_count);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder::Poll
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::size_t SampleFrameDecoder::Poll(Board<DefaultDataType>& board) {
+  std::size_t bytes_fed = 0;
+  while(auto chunk = board.Receive()) {
+    Feed(*chunk);
+    bytes_fed += chunk->size();
+  }
+  return bytes_fed;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder::Available
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::size_t SampleFrameDecoder::Available() {
+  const std::lock_guard<std::mutex> lock(rings_mutex_);
+  return available_;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder::Read
+      Copies up to max_count oldest samples of channel into dst, returns number of copied samples
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::size_t SampleFrameDecoder::Read(std::size_t channel, float* dst, std::size_t max_count) {
+  if(channel >= channels_count_)
+    return 0;
+
+  const std::lock_guard<std::mutex> lock(rings_mutex_);
+  const std::size_t count = std::min(max_count, available_);
+  const float* ring = rings_.data() + channel * capacity_;
+  const std::size_t read_pos = (write_pos_ + capacity_ - available_) % capacity_;
+
+  const std::size_t first_part = std::min(count, capacity_ - read_pos);
+  std::copy(ring + read_pos, ring + read_pos + first_part, dst);
+  std::copy(ring, ring + (count - first_part), dst + first_part);
+  return count;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SampleFrameDecoder::Consume
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void SampleFrameDecoder::Consume(std::size_t count) {
+  const std::lock_guard<std::mutex> lock(rings_mutex_);
+  available_ -= std::min(count, available_);
+}
+
+
+}  //namespace board_connect
+
+#endif     //SAMPLE_FRAME_DECODER_H
@@ -0,0 +1,356 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Serial port discovery header
+*/
+
+#ifndef SERIAL_PORT_DISCOVERY_H
+#define SERIAL_PORT_DISCOVERY_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <optional>
+
+#include "Declarations.h"
+#include "UartConnectionSettings.h"
+
+#include <setupapi.h>
+//GCC: g++ ... -lsetupapi
+
+
+namespace board_connect {
+
+namespace uart {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SerialPortInfo
+      port_name     - name to open the port with ("COM27"). May change after reboot or re-plug
+      instance_id   - device instance id ("USB\VID_0403&PID_6001\A600XYZ"). Stable for USB devices with serial number
+      serial_number - USB serial number, if it is a part of instance_id; empty otherwise
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct SerialPortInfo{
+  std::string port_name;
+  std::string instance_id;
+  std::string serial_number;
+
+  bool operator==(const SerialPortInfo& oth) const { return port_name == oth.port_name && instance_id == oth.instance_id; }
+
+    //identifier may be port name, instance id or serial number
+  bool Matches(const std::string& identifier) const {
+    return !identifier.empty() && (identifier == port_name || identifier == instance_id || identifier == serial_number);
+  }
+
+    //key of the device in BoardGroup: instance id, or port name if instance id is unknown
+  const std::string& Key() const { return instance_id.empty() ? port_name : instance_id; }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SerialPortInfoFromIds
+      Fills SerialPortInfo by port name and device instance id
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline SerialPortInfo SerialPortInfoFromIds(std::string port_name, std::string instance_id) {
+  SerialPortInfo info;
+  info.port_name = std::move(port_name);
+  info.instance_id = std::move(instance_id);
+
+    //"USB\VID_xxxx&PID_xxxx\<serial>". Generated ids (without serial number) contain '&'
+  if(info.instance_id.compare(0, 4, "USB\\") == 0) {
+    const std::size_t last_separator = info.instance_id.find_last_of('\\');
+    const std::string tail = info.instance_id.substr(last_separator + 1);
+    if(tail.find('&') == std::string::npos) {
+      info.serial_number = tail;
+    }
+  }
+  return info;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ForEachSerialPortDevice
+      Calls visit(device_info_set, device_info, port_name) for present devices of "Ports (COM & LPT)" class,
+      which have a port name, until visit returns false. Returns false if devices can't be enumerated
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename Visit>
+bool ForEachSerialPortDevice(Visit&& visit) {
+  //GUID_DEVCLASS_PORTS {4D36E978-E325-11CE-BFC1-08002BE10318}
+  static const GUID ports_class_guid = { 0x4D36E978, 0xE325, 0x11CE, { 0xBF, 0xC1, 0x08, 0x00, 0x2B, 0xE1, 0x03, 0x18 } };
+
+  HDEVINFO device_info_set = SetupDiGetClassDevsA(&ports_class_guid, nullptr, nullptr, DIGCF_PRESENT);
+  if(device_info_set == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  SP_DEVINFO_DATA device_info{};
+  device_info.cbSize = sizeof(device_info);
+  for(DWORD index = 0; SetupDiEnumDeviceInfo(device_info_set, index, &device_info); ++index) {
+      //port name is kept in device registry key
+    HKEY device_key = SetupDiOpenDevRegKey(device_info_set, &device_info, DICS_FLAG_GLOBAL, 0, DIREG_DEV, KEY_READ);
+    if(device_key == INVALID_HANDLE_VALUE) {
+      continue;
+    }
+    char port_name[256] = {0};
+    DWORD port_name_size = sizeof(port_name) - 1;
+    DWORD value_type = 0;
+    const LONG query_result = RegQueryValueExA(device_key, "PortName", nullptr, &value_type, reinterpret_cast<LPBYTE>(port_name), &port_name_size);
+    RegCloseKey(device_key);
+    if(query_result != ERROR_SUCCESS || value_type != REG_SZ) {
+      continue;
+    }
+    if(!visit(device_info_set, device_info, std::string(port_name))) {
+      break;
+    }
+  }
+
+  SetupDiDestroyDeviceInfoList(device_info_set);
+  return true;
+}
+
+
+  //device instance id of enumerated device, empty on error
+inline std::string DeviceInstanceId(HDEVINFO device_info_set, SP_DEVINFO_DATA& device_info) {
+  char instance_id[512] = {0};
+  if(!SetupDiGetDeviceInstanceIdA(device_info_set, &device_info, instance_id, sizeof(instance_id), nullptr)) {
+    return std::string();
+  }
+  return instance_id;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      EnumerateSerialPorts
+      Lists present devices of "Ports (COM & LPT)" class, which have a COM port name.
+      Returns empty vector on error
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::vector<SerialPortInfo> EnumerateSerialPorts() {
+  std::vector<SerialPortInfo> ports;
+  ForEachSerialPortDevice([&ports](HDEVINFO device_info_set, SP_DEVINFO_DATA& device_info, std::string port_name){
+    if(port_name.compare(0, 3, "COM") == 0) {       //not LPT or other non-serial device
+      ports.push_back(SerialPortInfoFromIds(std::move(port_name), DeviceInstanceId(device_info_set, device_info)));
+    }
+    return true;
+  });
+  return ports;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      FindSerialPort
+      Finds port by port name, instance id or serial number among given ports, or among present ones
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline std::optional<SerialPortInfo> FindSerialPort(const std::vector<SerialPortInfo>& ports, const std::string& identifier) {
+  for(const auto& info : ports) {
+    if(info.Matches(identifier)) {
+      return info;
+    }
+  }
+  return std::nullopt;
+}
+
+
+inline std::optional<SerialPortInfo> FindSerialPort(const std::string& identifier) {
+  return FindSerialPort(EnumerateSerialPorts(), identifier);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      OpenSerialPortDeviceKey
+      Opens device registry key ("Device Parameters") of present port with given name ("COM27" or "\\.\COM27").
+      instance_id receives device instance id. Returns INVALID_HANDLE_VALUE if port is not found or access is denied
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline HKEY OpenSerialPortDeviceKey(const std::string& port_name, REGSAM access, std::string& instance_id) {
+  const std::string device_namespace = "\\\\.\\";
+  const std::string name = (port_name.compare(0, device_namespace.size(), device_namespace) == 0) ?
+                            port_name.substr(device_namespace.size()) : port_name;
+
+  HKEY result = static_cast<HKEY>(INVALID_HANDLE_VALUE);
+  ForEachSerialPortDevice([&](HDEVINFO device_info_set, SP_DEVINFO_DATA& device_info, const std::string& current_name){
+    if(name != current_name)
+      return true;
+    instance_id = DeviceInstanceId(device_info_set, device_info);
+    result = SetupDiOpenDevRegKey(device_info_set, &device_info, DICS_FLAG_GLOBAL, 0, DIREG_DEV, access);
+    return false;
+  });
+  return result;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ApplyFtdiLatencyTimer
+      FTDI VCP driver keeps latency timer of adapter in "LatencyTimer" value of device registry key and reads it
+      when device is started. Sets the value if it differs from latency_ms (1..255).
+      Returns true if the value is already latency_ms. Otherwise driver still uses the old value: writing requires
+      administrator rights and takes effect after the adapter is re-plugged. Ports of other adapters are ignored (false)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool ApplyFtdiLatencyTimer(const std::string& port_name, unsigned latency_ms) {
+  const DWORD latency = std::clamp<DWORD>(latency_ms, 1, 255);
+  std::string instance_id;
+  HKEY device_key = OpenSerialPortDeviceKey(port_name, KEY_QUERY_VALUE, instance_id);
+  if(device_key == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  DWORD current = 0;
+  DWORD current_size = sizeof(current);
+  DWORD value_type = 0;
+  const LONG query_result = RegQueryValueExA(device_key, "LatencyTimer", nullptr, &value_type, reinterpret_cast<LPBYTE>(&current), &current_size);
+  RegCloseKey(device_key);
+  if(instance_id.compare(0, 8, "FTDIBUS\\") != 0 || query_result != ERROR_SUCCESS || value_type != REG_DWORD) {
+    return false;     //not an FTDI adapter
+  }
+  if(current == latency) {
+    return true;
+  }
+
+  device_key = OpenSerialPortDeviceKey(port_name, KEY_SET_VALUE, instance_id);
+  if(device_key == INVALID_HANDLE_VALUE
+     || RegSetValueExA(device_key, "LatencyTimer", 0, REG_DWORD, reinterpret_cast<const BYTE*>(&latency), sizeof(latency)) != ERROR_SUCCESS) {
+    cout<<port_name<<": FTDI latency timer is "<<current<<" ms, unable to set "<<latency<<" ms (administrator rights are required)"<<endl;
+  }
+  else {
+    cout<<port_name<<": FTDI latency timer is set to "<<latency<<" ms, it takes effect after the adapter is re-plugged"<<endl;
+  }
+  if(device_key != INVALID_HANDLE_VALUE) {
+    RegCloseKey(device_key);
+  }
+  return false;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SerialPortWatcher
+      Periodically enumerates serial ports in its own thread and reports appeared / disappeared ports.
+      Ports present at Start() are reported as appeared. Callbacks are called from watcher thread and
+      must be set before Start(). Per-port callbacks are called first, then OnChange() callback gets
+      all changes found by one enumeration at once (e.g. to connect several new boards in parallel).
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class SerialPortWatcher {
+
+public:
+  using Callback_t = std::function<void(const SerialPortInfo&)>;
+  using ChangeCallback_t = std::function<void(const std::vector<SerialPortInfo>& arrived, const std::vector<SerialPortInfo>& removed)>;
+
+private:
+  Callback_t on_arrival_;
+  Callback_t on_removal_;
+  ChangeCallback_t on_change_;
+  const Duration_t poll_period_;
+
+  struct ThreadWrapper{
+    thread th;
+    atomic_bool join_request;
+  };
+  ThreadWrapper watcher_thread_;
+
+private:
+  void WatcherLoop() noexcept;
+
+public:
+  //ctor / dtor
+  explicit SerialPortWatcher(Duration_t poll_period = 500ms) : poll_period_(poll_period) {
+    watcher_thread_.join_request.store(false, std::memory_order_relaxed);
+  }
+  SerialPortWatcher(const SerialPortWatcher& oth) = delete;
+  SerialPortWatcher& operator=(const SerialPortWatcher& oth) = delete;
+  virtual ~SerialPortWatcher() { Stop(); }
+
+public:
+  //API
+  void OnArrival(Callback_t callback) { on_arrival_ = std::move(callback); }
+  void OnRemoval(Callback_t callback) { on_removal_ = std::move(callback); }
+  void OnChange(ChangeCallback_t callback) { on_change_ = std::move(callback); }
+
+  void Start();
+  void Stop() noexcept;
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SerialPortWatcher::Start
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void SerialPortWatcher::Start() {
+  if(watcher_thread_.th.joinable())
+    return;
+  watcher_thread_.join_request.store(false, std::memory_order_relaxed);
+
+  //exception may be thrown if's impossible to create a new thread
+  watcher_thread_.th = thread{&SerialPortWatcher::WatcherLoop, this};
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SerialPortWatcher::Stop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void SerialPortWatcher::Stop() noexcept {
+  watcher_thread_.join_request.store(true, std::memory_order_relaxed);
+  if(watcher_thread_.th.joinable()) {
+    watcher_thread_.th.join();
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SerialPortWatcher::WatcherLoop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void SerialPortWatcher::WatcherLoop() noexcept {
+  auto& stop_request_atomic = watcher_thread_.join_request;
+  std::vector<SerialPortInfo> known_ports;
+
+  while(!stop_request_atomic.load(std::memory_order_relaxed)) {
+    try{
+      const std::vector<SerialPortInfo> current_ports = EnumerateSerialPorts();
+
+      std::vector<SerialPortInfo> removed;
+      std::vector<SerialPortInfo> arrived;
+      for(const auto& info : known_ports) {
+        if(std::find(current_ports.begin(), current_ports.end(), info) == current_ports.end()) {
+          removed.push_back(info);
+        }
+      }
+      for(const auto& info : current_ports) {
+        if(std::find(known_ports.begin(), known_ports.end(), info) == known_ports.end()) {
+          arrived.push_back(info);
+        }
+      }
+      known_ports = current_ports;
+
+      for(const auto& info : removed) {
+        if(on_removal_)
+          on_removal_(info);
+      }
+      for(const auto& info : arrived) {
+        if(on_arrival_)
+          on_arrival_(info);
+      }
+      if(on_change_ && (!arrived.empty() || !removed.empty())) {
+        on_change_(arrived, removed);
+      }
+    }
+    catch(...){
+      cout<<"Error in serial port watcher loop"<<endl;
+    }
+
+    std::this_thread::sleep_for(poll_period_);
+  }
+}
+
+
+}  //uart
+
+}  //board_connect
+
+#endif  //SERIAL_PORT_DISCOVERY_H
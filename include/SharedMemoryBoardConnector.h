@@ -0,0 +1,148 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  SharedMemoryBoardConnector header
+*/
+
+#ifndef SHARED_MEMORY_BOARD_CONNECTOR_H
+#define SHARED_MEMORY_BOARD_CONNECTOR_H
+
+#include <vector>
+
+#include "Declarations.h"
+#include "IBoardConnector.h"
+#include "SharedMemoryConnectionSettings.h"
+#include "SharedMemoryRing.h"
+#include "MessageCodec.h"
+
+namespace board_connect {
+
+namespace shared_memory {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnector
+      Read-only connector to a board, owned by another process, which publishes received data into shared memory.
+      Data is decoded directly from the ring slot on Receive(), no service threads are needed. Send() always fails.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class SharedMemoryBoardConnector : public IBoardConnector<DataType> {
+private:
+  const SharedMemoryConnectionSettings settings_;
+
+  mutex reader_mutex_;
+  SharedMemoryReader reader_;
+
+public:
+  SharedMemoryBoardConnector( const IConnectionSettings& settings) 
+    : settings_(static_cast<const SharedMemoryConnectionSettings&>(settings)) {}
+    
+  virtual ~SharedMemoryBoardConnector() = default;
+  
+public:
+  ConnectionStatus_t Connect() override;
+  ConnectionStatus_t Status() noexcept override;
+  ConnectionStatus_t Disconnect() noexcept override;
+  
+  bool Send(DataType) override { return false; }
+  bool SendShared(SharedParcel<DataType>) override { return false; }
+  bool SendSlice(SharedParcel<DataType>, std::size_t, std::size_t) override { return false; }
+  std::optional<DataType> Receive() override;
+  std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() override;
+  
+  std::uint64_t LostCount() { const lock_guard<mutex> lock(reader_mutex_); return reader_.LostCount(); }
+  std::uint64_t DroppedCount() { const lock_guard<mutex> lock(reader_mutex_); return reader_.DroppedCount(); }   //too large for the ring
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnectorFactory
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class SharedMemoryBoardConnectorFactory : public IBoardConnectorFactory<DataType> {
+public:
+  ~SharedMemoryBoardConnectorFactory() override {}
+public:
+  IBoardConnector_up<DataType> MakeBoardConnector( const IConnectionSettings& connection_settings) const override {
+    return std::make_unique<SharedMemoryBoardConnector<DataType>>(connection_settings);
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnector::Connect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t SharedMemoryBoardConnector<DataType>::Connect() {
+  const lock_guard<mutex> lock(reader_mutex_);
+  if(!reader_.Open(settings_.name)) {
+    return this->current_state_ = ConnectionStatus_t::CONNECTION_ERROR;
+  }
+  return this->current_state_ = ConnectionStatus_t::CONNECTED_OK;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnector::Status
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t SharedMemoryBoardConnector<DataType>::Status() noexcept {
+  return this->current_state_;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnector::Disconnect
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t SharedMemoryBoardConnector<DataType>::Disconnect() noexcept {
+  const lock_guard<mutex> lock(reader_mutex_);
+  reader_.Close();
+  return this->current_state_ = ConnectionStatus_t::DISCONNECTED_OK;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnector::Receive
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<DataType> SharedMemoryBoardConnector<DataType>::Receive() {
+  auto rx_data = ReceiveTimestamped();
+  if(rx_data == nullopt) {
+    return nullopt;
+  }
+  return std::move(rx_data->data);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryBoardConnector::ReceiveTimestamped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<TimestampedParcel<DataType>> SharedMemoryBoardConnector<DataType>::ReceiveTimestamped() {
+  const lock_guard<mutex> lock(reader_mutex_);
+  TimePoint_t timestamp;
+  auto rx_data = reader_.ReadInPlace([](const char* raw, std::size_t size){
+    return codec::FromRaw<DataType>(raw, size);
+  }, timestamp);
+  if(rx_data == nullopt) {
+    return nullopt;
+  }
+  return TimestampedParcel<DataType>{ std::move(*rx_data), timestamp };
+}
+
+  
+} //shared_memory
+
+}  //board_connect
+
+#endif  //SHARED_MEMORY_BOARD_CONNECTOR_H
@@ -0,0 +1,70 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  SharedMemoryConnectionSettings header
+*/
+
+#ifndef SHARED_MEMORY_CONNECTION_SETTINGS_H
+#define SHARED_MEMORY_CONNECTION_SETTINGS_H
+
+#include <cstdint>
+
+#include "Declarations.h"
+
+namespace board_connect {
+
+namespace shared_memory {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryConnectionSettings
+      name of ring, created by publisher (see PublishingBoardConnector)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct SharedMemoryConnectionSettings : IConnectionSettings {
+
+public:
+  const std::string name;
+
+public:
+  explicit SharedMemoryConnectionSettings(const std::string& ring_name) : name(ring_name) {}
+  virtual ~SharedMemoryConnectionSettings() = default;
+
+public:
+  void Dump() const override  {
+    cout<<"SharedMemoryName = "<<name<<endl;
+  };
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      PublishingConnectionSettings
+      ring created by PublishingBoardConnector. Messages larger than slot_size are not published
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct PublishingConnectionSettings : IConnectionSettings {
+
+public:
+  const std::string name;
+  std::uint32_t slot_count = 1024;
+  std::uint32_t slot_size = 256;
+
+public:
+  explicit PublishingConnectionSettings(const std::string& ring_name) : name(ring_name) {}
+  virtual ~PublishingConnectionSettings() = default;
+
+public:
+  void Dump() const override  {
+    cout<<"SharedMemoryName = "<<name<<endl;
+    cout<<"SlotCount = "<<slot_count<<", SlotSize = "<<slot_size<<endl;
+  };
+};
+
+
+}  //shared_memory
+
+}  //board_connect
+
+#endif  //SHARED_MEMORY_CONNECTION_SETTINGS_H
@@ -0,0 +1,309 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Shared memory ring header
+*/
+
+#ifndef SHARED_MEMORY_RING_H
+#define SHARED_MEMORY_RING_H
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+#include "Declarations.h"
+
+
+namespace board_connect {
+
+namespace shared_memory {
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Layout of shared memory
+        RingHeader | slot 0 | slot 1 | ... | slot (slot_count - 1)
+      each slot is SlotHeader followed by slot_size bytes of data.
+      Message number n (starting from 1) is written into slot n % slot_count.
+      Slot sequence is 2n + 1 while message n is being written and 2n when it's complete (seqlock),
+      so readers never block the publisher: lagging reader detects overwritten slots and skips them.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+constexpr std::uint32_t RING_MAGIC = 0x42434D52;      //"BCMR"
+
+struct RingHeader{
+  std::atomic<std::uint32_t> magic;                  //set by publisher when header is initialized
+  std::uint32_t slot_count;
+  std::uint32_t slot_size;
+  std::uint32_t slot_stride;
+  std::atomic<std::uint64_t> write_seq;              //number of the last complete message
+  std::atomic<std::uint64_t> dropped_count;          //messages refused by publisher: larger than slot_size
+};
+
+struct SlotHeader{
+  std::atomic<std::uint64_t> seq;
+  std::uint32_t size;
+  std::int64_t timestamp;                            //TimePoint_t ticks. Steady clock is common for all processes on host
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "lock-free 64-bit atomics are required in shared memory");
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+inline std::uint32_t SlotStride(std::uint32_t slot_size) {
+  const std::size_t raw = sizeof(SlotHeader) + slot_size;
+  return static_cast<std::uint32_t>((raw + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE);
+}
+
+inline std::size_t MappingSize(std::uint32_t slot_count, std::uint32_t slot_size) {
+  return CACHE_LINE_SIZE + static_cast<std::size_t>(slot_count) * SlotStride(slot_size);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryRing
+      Owns file mapping handle and mapped view
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class SharedMemoryRing{
+
+protected:
+  Handler mapping_ = nullptr;
+  unsigned char* view_ = nullptr;
+
+protected:
+  RingHeader& Header() const { return *reinterpret_cast<RingHeader*>(view_); }
+  SlotHeader& Slot(std::uint64_t seq) const {
+    const RingHeader& header = Header();
+    return *reinterpret_cast<SlotHeader*>(view_ + CACHE_LINE_SIZE + (seq % header.slot_count) * header.slot_stride);
+  }
+  unsigned char* SlotData(SlotHeader& slot) const { return reinterpret_cast<unsigned char*>(&slot) + sizeof(SlotHeader); }
+
+  void Release() noexcept {
+    if(view_ != nullptr) {
+      UnmapViewOfFile(view_);
+      view_ = nullptr;
+    }
+    if(mapping_ != nullptr) {
+      CloseHandle(mapping_);
+      mapping_ = nullptr;
+    }
+  }
+
+public:
+  SharedMemoryRing() = default;
+  SharedMemoryRing(const SharedMemoryRing& oth) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing& oth) = delete;
+  virtual ~SharedMemoryRing() { Release(); }
+
+  bool IsOpen() const { return view_ != nullptr; }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryPublisher
+      Creates named ring and writes messages into it. Only one publisher per ring is allowed.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class SharedMemoryPublisher : public SharedMemoryRing{
+
+  std::mutex publish_mutex_;
+  std::uint64_t last_seq_ = 0;             //guarded by publish_mutex_
+
+public:
+  SharedMemoryPublisher(const std::string& name, std::uint32_t slot_count = 1024, std::uint32_t slot_size = 256);
+
+  bool Publish(const char* data, std::size_t size, TimePoint_t timestamp = Clock_t::now()) noexcept;   //false if message is larger than slot
+  std::uint64_t DroppedCount() const { return Header().dropped_count.load(std::memory_order_relaxed); }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryPublisher:: constructor
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline SharedMemoryPublisher::SharedMemoryPublisher(const std::string& name, std::uint32_t slot_count, std::uint32_t slot_size) {
+  if(slot_count == 0 || slot_size == 0) {
+    throw std::invalid_argument("SharedMemoryPublisher: slot count and slot size must be positive");
+  }
+
+  const unsigned long long mapping_size = MappingSize(slot_count, slot_size);
+  mapping_ = CreateFileMappingA(  INVALID_HANDLE_VALUE,
+                                  nullptr,
+                                  PAGE_READWRITE,
+                                  static_cast<DWORD>(mapping_size >> 32),
+                                  static_cast<DWORD>(mapping_size & 0xFFFFFFFF),
+                                  name.c_str());
+  if(mapping_ == nullptr) {
+    throw std::runtime_error("Unable to create shared memory");
+  }
+  if(GetLastError() == ERROR_ALREADY_EXISTS) {
+    Release();
+    throw std::runtime_error("Shared memory with this name already exists");
+  }
+
+  view_ = static_cast<unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, mapping_size));
+  if(view_ == nullptr) {
+    Release();
+    throw std::runtime_error("Unable to map shared memory");
+  }
+
+  //new mapping is zero-filled, so all atomics are already 0
+  RingHeader& header = Header();
+  header.slot_count = slot_count;
+  header.slot_size = slot_size;
+  header.slot_stride = SlotStride(slot_size);
+  header.magic.store(RING_MAGIC, std::memory_order_release);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryPublisher::Publish
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool SharedMemoryPublisher::Publish(const char* data, std::size_t size, TimePoint_t timestamp) noexcept {
+  RingHeader& header = Header();
+  if(size > header.slot_size) {
+    header.dropped_count.fetch_add(1, std::memory_order_relaxed);     //readers see it as well
+    return false;
+  }
+
+  const std::lock_guard<std::mutex> lock(publish_mutex_);
+  const std::uint64_t seq = ++last_seq_;
+  SlotHeader& slot = Slot(seq);
+
+  slot.seq.store(2 * seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.size = static_cast<std::uint32_t>(size);
+  slot.timestamp = timestamp.time_since_epoch().count();
+  std::memcpy(SlotData(slot), data, size);
+  slot.seq.store(2 * seq, std::memory_order_release);
+
+  header.write_seq.store(seq, std::memory_order_release);
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryReader
+      Opens existing ring read-only. Each reader has its own cursor, readers do not affect each other.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class SharedMemoryReader : public SharedMemoryRing{
+
+  std::uint64_t next_seq_ = 0;
+  std::uint64_t lost_count_ = 0;
+
+public:
+  bool Open(const std::string& name) noexcept;     //reading starts from messages published after Open()
+  void Close() noexcept { Release(); }
+
+    //copies next message into out. false if there is no new message
+  bool Read(std::vector<char>& out, TimePoint_t& timestamp) noexcept;
+    //decodes next message straight from its slot: decode(const char* data, std::size_t size) -> std::optional<T>.
+    //Writer may overwrite the slot meanwhile, so decode must accept any bytes; such result is discarded.
+    //Messages, for which decode returns nullopt, are skipped
+  template <typename Decode>
+  auto ReadInPlace(Decode&& decode, TimePoint_t& timestamp) -> decltype(decode(static_cast<const char*>(nullptr), std::size_t{}));
+  std::uint64_t LostCount() const { return lost_count_; }     //messages overwritten before this reader got them
+  std::uint64_t DroppedCount() const { return IsOpen() ? Header().dropped_count.load(std::memory_order_relaxed) : 0; }   //refused by publisher
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryReader::Open
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool SharedMemoryReader::Open(const std::string& name) noexcept {
+  Release();
+
+  mapping_ = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+  if(mapping_ == nullptr) {
+    return false;
+  }
+  view_ = static_cast<unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if(view_ == nullptr) {
+    Release();
+    return false;
+  }
+
+  RingHeader& header = Header();
+  if(header.magic.load(std::memory_order_acquire) != RING_MAGIC) {
+    Release();      //publisher has not finished initialization, or it's not a ring
+    return false;
+  }
+
+  next_seq_ = header.write_seq.load(std::memory_order_acquire) + 1;
+  lost_count_ = 0;
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryReader::Read
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool SharedMemoryReader::Read(std::vector<char>& out, TimePoint_t& timestamp) noexcept {
+  return ReadInPlace([&out](const char* data, std::size_t size){
+    out.assign(data, data + size);
+    return std::optional<bool>(true);
+  }, timestamp).has_value();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      SharedMemoryReader::ReadInPlace
+      Seqlock read: slot sequence is checked again after decoding, decoded value of overwritten slot is dropped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename Decode>
+auto SharedMemoryReader::ReadInPlace(Decode&& decode, TimePoint_t& timestamp)
+  -> decltype(decode(static_cast<const char*>(nullptr), std::size_t{})) {
+  using Result_t = decltype(decode(static_cast<const char*>(nullptr), std::size_t{}));
+  if(!IsOpen())
+    return Result_t{};
+
+  RingHeader& header = Header();
+  while(true) {
+    const std::uint64_t write_seq = header.write_seq.load(std::memory_order_acquire);
+    if(next_seq_ > write_seq)
+      return Result_t{};
+
+      //reader is behind by more than whole ring: oldest messages are already overwritten
+    if(write_seq - next_seq_ >= header.slot_count) {
+      const std::uint64_t oldest = write_seq - header.slot_count + 1;
+      lost_count_ += oldest - next_seq_;
+      next_seq_ = oldest;
+    }
+
+    SlotHeader& slot = Slot(next_seq_);
+    const std::uint64_t seq_before = slot.seq.load(std::memory_order_acquire);
+    if(seq_before == 2 * next_seq_) {
+      const std::uint32_t size = std::min(slot.size, header.slot_size);
+      const std::int64_t ticks = slot.timestamp;
+      Result_t result = decode(reinterpret_cast<const char*>(SlotData(slot)), size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(slot.seq.load(std::memory_order_relaxed) == seq_before) {
+        ++next_seq_;
+        if(!result)
+          continue;         //message of another type
+        timestamp = TimePoint_t(Clock_t::duration(ticks));
+        return result;
+      }
+    }
+
+      //slot was overwritten by newer message before or during decoding
+    ++lost_count_;
+    ++next_seq_;
+  }
+}
+
+
+}  //shared_memory
+
+}  //board_connect
+
+#endif  //SHARED_MEMORY_RING_H
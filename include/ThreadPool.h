@@ -0,0 +1,229 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  class WorkStealingPool
+
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include "Declarations.h"
+
+
+namespace board_connect{
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      class WorkStealingPool declaration
+      Each worker has its own task queue. Tasks are distributed between queues in round-robin manner,
+      worker takes tasks from the front of its own queue and steals from the back of other queues when idle.
+      Busy workers touch only queue mutexes: number of queued tasks is an atomic counter, wake_mutex_ is
+      locked only to put idle worker to sleep and to wake it up.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+class WorkStealingPool{
+
+public:
+  using Task_t = std::function<void()>;
+
+private:
+  struct WorkerQueue{
+    std::mutex queue_mutex;
+    std::deque<Task_t> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<thread> workers_;
+
+  std::atomic<std::size_t> pending_{0};       //tasks in queues. Changed under mutex of the queue, together with it
+  std::atomic<std::size_t> sleeping_{0};      //workers waiting on wake_cv_
+  std::atomic<std::size_t> submitting_{0};    //Submit() calls, which have passed check of join_request_
+  std::atomic<bool> join_request_{false};
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+
+  std::atomic<std::size_t> next_queue_{0};
+
+private:
+  void WorkerLoop(std::size_t index) noexcept;
+  bool TakeTask(std::size_t index, Task_t& task);
+  void WakeWorkers(bool all);
+  bool Finished() const { return join_request_ && submitting_ == 0 && pending_ == 0; }
+
+public:
+  //ctor / dtor
+  explicit WorkStealingPool(std::size_t threads_count = std::thread::hardware_concurrency());
+  WorkStealingPool(const WorkStealingPool& oth) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool& oth) = delete;
+  virtual ~WorkStealingPool() { Shutdown(); }
+
+public:
+  //API
+  bool Submit(Task_t task);          //false if pool is shut down, task is not executed then
+  void Shutdown() noexcept;          //executes remaining tasks and joins workers
+  std::size_t ThreadsCount() const { return workers_.size(); }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      WorkStealingPool:: constructor
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline WorkStealingPool::WorkStealingPool(std::size_t threads_count) {
+  if(threads_count == 0)
+    threads_count = 1;
+
+  for(std::size_t i = 0; i < threads_count; ++i) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  try {
+    for(std::size_t i = 0; i < threads_count; ++i) {
+      //exception may be thrown if's impossible to create a new thread
+      workers_.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+  }
+  catch(...) {
+    Shutdown();
+    throw;
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      WorkStealingPool::Submit
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool WorkStealingPool::Submit(Task_t task) {
+  ++submitting_;
+  if(join_request_) {
+    --submitting_;
+    return false;
+  }
+
+  WorkerQueue& queue = *queues_[next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size()];
+  try {
+    const std::lock_guard<std::mutex> lock(queue.queue_mutex);
+    queue.tasks.push_back(std::move(task));
+    ++pending_;
+  }
+  catch(...) {
+    --submitting_;
+    throw;
+  }
+  --submitting_;
+
+    //pending_ is incremented before sleeping_ is read, and worker increments sleeping_ before it checks pending_,
+    //so either worker sees the task or it's woken up here
+  if(sleeping_ > 0) {
+    WakeWorkers(false);
+  }
+  return true;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      WorkStealingPool::WakeWorkers
+      Notification under wake_mutex_: worker, which has checked the condition, is already waiting
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void WorkStealingPool::WakeWorkers(bool all) {
+  const std::lock_guard<std::mutex> lock(wake_mutex_);
+  if(all) {
+    wake_cv_.notify_all();
+  }
+  else {
+    wake_cv_.notify_one();
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      WorkStealingPool::Shutdown
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void WorkStealingPool::Shutdown() noexcept {
+  join_request_ = true;
+    //Submit() calls in progress either enqueue their tasks or refuse them
+  while(submitting_ > 0) {
+    std::this_thread::yield();
+  }
+  try {
+    WakeWorkers(true);
+  }
+  catch(...) {
+    std::terminate();     //as exception of mutex in destructor
+  }
+  for(auto& worker : workers_) {
+    if(worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      WorkStealingPool::TakeTask
+      Own queue first (oldest task), then other queues (newest task)
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline bool WorkStealingPool::TakeTask(std::size_t index, Task_t& task) {
+  for(std::size_t shift = 0; shift < queues_.size(); ++shift) {
+    WorkerQueue& queue = *queues_[(index + shift) % queues_.size()];
+    const std::lock_guard<std::mutex> lock(queue.queue_mutex);
+    if(queue.tasks.empty())
+      continue;
+    if(shift == 0) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    else {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    --pending_;
+    return true;
+  }
+  return false;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      WorkStealingPool::WorkerLoop
+    --------------------------------------------------------------------------------------------------------------------
+*/
+inline void WorkStealingPool::WorkerLoop(std::size_t index) noexcept {
+  Task_t task;
+  while(true) {
+    if(TakeTask(index, task)) {
+      try{
+        task();
+      }
+      catch(...){
+        cout<<"Error in thread pool task"<<endl;
+      }
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    ++sleeping_;
+    wake_cv_.wait(lock, [this]{ return pending_ > 0 || Finished(); });
+    --sleeping_;
+    if(Finished())
+      break;    //join requested and nothing left
+  }
+}
+
+
+}  //namespace board_connect
+
+#endif     //THREAD_POOL_H
@@ -12,21 +12,49 @@
 #include "Declarations.h"
 #include "IBoardConnector.h"
 #include "UartConnectionSettings.h"
+#include "SerialPortDiscovery.h"
+#include "Pacer.h"
+#include "MessageCodec.h"
 
 namespace board_connect {
   
 namespace uart {
   
   
+/*  --------------------------------------------------------------------------------------------------------------------
+      OverlappedOperation
+      OVERLAPPED structure with its own manual-reset event. One per service thread: overlapped operations
+      of sender and receiver do not wait for each other
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct OverlappedOperation{
+  OVERLAPPED overlapped{};
+
+  OverlappedOperation() { overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr); }
+  OverlappedOperation(const OverlappedOperation& oth) = delete;
+  OverlappedOperation& operator=(const OverlappedOperation& oth) = delete;
+  ~OverlappedOperation() { if(overlapped.hEvent != nullptr) CloseHandle(overlapped.hEvent); }
+
+  bool Valid() const { return overlapped.hEvent != nullptr; }
+};
+
+
 /*  --------------------------------------------------------------------------------------------------------------------
       UartBoardConnector
+      Port is opened for overlapped I/O. Service threads wait for their operations together with stop_event_,
+      so Disconnect() does not wait for a pending read or for idle period to end.
+      Receiver waits for arrival of data (WaitCommEvent), not for receive_loop_period: each chunk is timestamped
+      when the driver reports it.
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
 class UartBoardConnector : public IBoardConnector<DataType> {
 private:
   const UartConnectionSettings uart_settings_;
-  Handler handler_;  
+  Handler handler_ = INVALID_HANDLE_VALUE;      //changed only while service threads are stopped
+  Handler stop_event_ = nullptr;                //manual-reset, set by Disconnect(), reset by Connect()
+  Handler send_event_ = nullptr;                //auto-reset, set when parcel is queued for sending
+  Pacer pacer_;
   
   struct ThreadWrapper{
     thread th;
@@ -36,12 +64,13 @@ private:
   ThreadWrapper sender_thread_;
   ThreadWrapper receiver_thread_;
   
-  atomic_bool disconnection_in_progress_flag_;
-  atomic_bool connection_in_progress_flag_;
+  mutex lifecycle_mutex_;        //Connect() and Disconnect() may be called from different threads
   
 private:
   bool InitializeCOMPort() noexcept;
   void ReleaseCOMPort() noexcept;
+  bool CompleteOverlapped(BOOL started, OverlappedOperation& operation, DWORD& transferred) noexcept;
+  bool WaitIdle(Handler wake_event, Duration_t period) noexcept;
   void StartSenderService();
   void StartReceiverService();
   void StopSenderService() noexcept;
@@ -50,20 +79,28 @@ private:
   void ReceiverLoop() noexcept;
   void SenderLoopErrorHandler() noexcept;
   void ReceiverLoopErrorHandler() noexcept;
+  ConnectionStatus_t DisconnectUnlocked() noexcept;
   
 public:
   UartBoardConnector( const IConnectionSettings& uart_settings) 
-    : uart_settings_(static_cast<const UartConnectionSettings&>(uart_settings)) {}
+    : uart_settings_(static_cast<const UartConnectionSettings&>(uart_settings)),
+      stop_event_(CreateEventA(nullptr, TRUE, FALSE, nullptr)),
+      send_event_(CreateEventA(nullptr, FALSE, FALSE, nullptr)),
+      pacer_( uart_settings_.pacing_bytes_per_second, uart_settings_.pacing_bytes_burst,
+              uart_settings_.pacing_parcels_per_second, uart_settings_.pacing_parcels_burst ) {}
     
-  virtual ~UartBoardConnector() = default;
+  virtual ~UartBoardConnector();
   
 public:
   ConnectionStatus_t Connect() override;
   ConnectionStatus_t Status() noexcept override;
   ConnectionStatus_t Disconnect() noexcept override;
   
-  bool Send(const DataType data) override;
+  bool Send(DataType data) override;
+  bool SendShared(SharedParcel<DataType> parcel) override;
+  bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) override;
   std::optional<DataType> Receive() override;
+  std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() override;
   
 };  
 
@@ -81,6 +118,23 @@ public:
 };
 
 
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector:: destructor
+      Events are kept for the whole life of connector: Send() may be called concurrently with Disconnect()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+UartBoardConnector<DataType>::~UartBoardConnector() {
+  Disconnect();     //service threads must not outlive connector
+  if(stop_event_ != nullptr) {
+    CloseHandle(stop_event_);
+  }
+  if(send_event_ != nullptr) {
+    CloseHandle(send_event_);
+  }
+}
+
+
 /*  --------------------------------------------------------------------------------------------------------------------
       UartBoardConnector methods
       UartBoardConnector::InitializeCOMPort
@@ -89,7 +143,8 @@ public:
 template <typename DataType>
 bool UartBoardConnector<DataType>::InitializeCOMPort() noexcept {
   try  {
-    LPCSTR port_name = uart::ConvertPortNameToStr(uart_settings_.port).data();
+    const std::string device_path = uart::ConvertPortNameToDevicePath(uart_settings_.port_path);
+    LPCSTR port_name = device_path.data();
     
     /*  - - - -  - - -  - */
     //Get handle
@@ -98,7 +153,7 @@ bool UartBoardConnector<DataType>::InitializeCOMPort() noexcept {
                             0, 
                             0, 
                             OPEN_EXISTING, 
-                            FILE_ATTRIBUTE_NORMAL, 
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, 
                             0);
                             
     if(handler_ == INVALID_HANDLE_VALUE)  {
@@ -110,9 +165,27 @@ bool UartBoardConnector<DataType>::InitializeCOMPort() noexcept {
       }
     }  
     
+    if(stop_event_ == nullptr || send_event_ == nullptr || !ResetEvent(stop_event_)) {
+      throw std::runtime_error("Error when creating events of COM port");
+    }
+    
+    /*  - - - -  - - -  - */
+    //Set driver buffers size  
+    if(uart_settings_.input_queue_size > 0 || uart_settings_.output_queue_size > 0) {
+      if(!SetupComm(handler_, uart_settings_.input_queue_size, uart_settings_.output_queue_size)) {
+        throw std::runtime_error("Error when setting queue sizes");
+      }
+    }
+    
     /*  - - - -  - - -  - */
     //Set Communication timeouts  
     COMMTIMEOUTS commtimeouts = uart_settings_.winapi_commtimeouts;
+    if(uart_settings_.low_latency) {
+      //return as soon as at least one byte is received, or after timeout constant
+      commtimeouts.ReadIntervalTimeout = MAXDWORD;
+      commtimeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+      commtimeouts.ReadTotalTimeoutConstant = uart_settings_.receive_loop_period.count();
+    }
     
     if(!SetCommTimeouts(handler_, &commtimeouts)){
       throw std::runtime_error("Error when setting timeouts");
@@ -125,14 +198,56 @@ bool UartBoardConnector<DataType>::InitializeCOMPort() noexcept {
     if (!GetCommState(handler_, &dcbSerialParams))  {
       throw std::runtime_error("Error when getting dcbSerialParams");
     }
-    dcbSerialParams.BaudRate = uart_settings_.baud;
+    //any baud rate is passed to driver as is, non-standard rates (e.g. 2000000 for FTDI) are supported by many adapters
+    if(uart_settings_.baud <= 0 || uart_settings_.baud > static_cast<BaudRate_t>(MAXDWORD)) {
+      throw std::runtime_error("Invalid baud rate");
+    }
+    dcbSerialParams.BaudRate = static_cast<DWORD>(uart_settings_.baud);
     dcbSerialParams.ByteSize = uart_settings_.length;
-    dcbSerialParams.StopBits = uart_settings_.stop_bits;
+    dcbSerialParams.StopBits = (uart_settings_.stop_bits == STOP_TWO) ? TWOSTOPBITS : ONESTOPBIT;
     dcbSerialParams.Parity = uart_settings_.parity;
+    dcbSerialParams.fBinary = TRUE;
+    dcbSerialParams.fParity = (uart_settings_.parity != UART_PARITY_NONE);
+    
+    //flow control
+    dcbSerialParams.fOutxCtsFlow = FALSE;
+    dcbSerialParams.fRtsControl = RTS_CONTROL_ENABLE;
+    dcbSerialParams.fOutX = FALSE;
+    dcbSerialParams.fInX = FALSE;
+    switch(uart_settings_.flow_control) {
+    case FLOW_RTS_CTS:
+      dcbSerialParams.fOutxCtsFlow = TRUE;
+      dcbSerialParams.fRtsControl = RTS_CONTROL_HANDSHAKE;
+      break;
+    case FLOW_XON_XOFF:
+      dcbSerialParams.fOutX = TRUE;
+      dcbSerialParams.fInX = TRUE;
+      dcbSerialParams.XonChar = 0x11;
+      dcbSerialParams.XoffChar = 0x13;
+      break;
+    default:
+      break;
+    }
+    
     if(!SetCommState(handler_, &dcbSerialParams)) {
       throw std::runtime_error("Error when setting serial params");
     }
     
+    /* - - - - - -  */
+    //FTDI adapters keep received bytes in their buffer up to latency timer (16 ms by default).
+    //The timer is a setting of the driver, not of the port: it's checked here, failure is not an error
+    if(uart_settings_.low_latency && uart_settings_.ftdi_latency_timer > 0) {
+      ApplyFtdiLatencyTimer(uart_settings_.port_path, uart_settings_.ftdi_latency_timer);
+    }
+    
+    /* - - - - - -  */
+    //drop data left in driver buffers
+    if(uart_settings_.purge_on_connect) {
+      if(!PurgeComm(handler_, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR)) {
+        throw std::runtime_error("Error when purging port buffers");
+      }
+    }
+    
   }
   catch(std::runtime_error& err){
     cout<<err.what()<<endl;
@@ -151,7 +266,48 @@ template <typename DataType>
 void UartBoardConnector<DataType>::ReleaseCOMPort() noexcept {
   if(handler_ != INVALID_HANDLE_VALUE) {
     CloseHandle(handler_);  
+    handler_ = INVALID_HANDLE_VALUE;
+  }
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::CompleteOverlapped
+      Waits for operation started by ReadFile() / WriteFile() (started - their result).
+      Returns false if operation failed or stop_event_ is set: pending operation is cancelled then.
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool UartBoardConnector<DataType>::CompleteOverlapped(BOOL started, OverlappedOperation& operation, DWORD& transferred) noexcept {
+  transferred = 0;
+  if(!started && GetLastError() != ERROR_IO_PENDING) {
+    return false;
+  }
+  if(!started) {
+    const HANDLE events[2] = { operation.overlapped.hEvent, stop_event_ };
+    if(WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0) {
+      CancelIo(handler_);     //cancels operations of calling thread only
+        //buffer of operation must stay valid until the driver is done with it
+      GetOverlappedResult(handler_, &operation.overlapped, &transferred, TRUE);
+      transferred = 0;
+      return false;
+    }
   }
+  return GetOverlappedResult(handler_, &operation.overlapped, &transferred, FALSE);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::WaitIdle
+      Pause of service loop: up to period, until wake_event (may be nullptr) or stop_event_ is set.
+      Returns false if stop_event_ is set
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool UartBoardConnector<DataType>::WaitIdle(Handler wake_event, Duration_t period) noexcept {
+  const HANDLE events[2] = { stop_event_, wake_event };
+  const DWORD events_count = (wake_event == nullptr) ? 1 : 2;
+  return WaitForMultipleObjects(events_count, events, FALSE, static_cast<DWORD>(period.count())) != WAIT_OBJECT_0;
 }
 
 
@@ -161,9 +317,12 @@ void UartBoardConnector<DataType>::ReleaseCOMPort() noexcept {
 */
 template <typename DataType>
 ConnectionStatus_t UartBoardConnector<DataType>::Connect() {
+  const lock_guard<mutex> lock(lifecycle_mutex_);
 
-  if(this->current_state_ == ConnectionStatus_t::CONNECTED_OK) 
-    Disconnect();
+    //services are stopped in any state: they may be left running after failed connection
+  DisconnectUnlocked();
+  this->current_state_ = ConnectionStatus_t::CONNECTION_IN_PROGRESS;
+  pacer_.Reset();       //sender is stopped, debt of previous connection must not delay the first parcels
   
   bool COM_initialized = InitializeCOMPort();
   if(!COM_initialized){
@@ -175,7 +334,7 @@ ConnectionStatus_t UartBoardConnector<DataType>::Connect() {
     StartReceiverService();
   }
   catch(std::exception& err) {
-    Disconnect();
+    DisconnectUnlocked();
     cout<<"Unable to start sender / receiver services. Connection cancelled"<<endl;
     return this->current_state_ = ConnectionStatus_t::OTHER_ERROR;
   }
@@ -190,20 +349,8 @@ ConnectionStatus_t UartBoardConnector<DataType>::Connect() {
 */
 template <typename DataType>
 ConnectionStatus_t UartBoardConnector<DataType>::Status() noexcept {
-  
-  switch(this->current_state_){
-    
-  case ConnectionStatus_t::CONNECTED_OK:
-    if(handler_ == INVALID_HANDLE_VALUE){
-      this->current_state_ = ConnectionStatus_t::CONNECTION_LOST;
-    }
-    break;
-    
-  default:
-    break;
-  }
-  
-  //in other cases just return current state
+  //handler_ is not checked here: it's valid whenever state is CONNECTED_OK, and it's changed by Connect() / Disconnect(),
+  //which may run in another thread
   return this->current_state_;
 }
 
@@ -214,10 +361,28 @@ ConnectionStatus_t UartBoardConnector<DataType>::Status() noexcept {
 */
 template <typename DataType>
 ConnectionStatus_t UartBoardConnector<DataType>::Disconnect() noexcept {
+  const lock_guard<mutex> lock(lifecycle_mutex_);     //exception of mutex in noexcept function terminates, as in destructor
+  return DisconnectUnlocked();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::DisconnectUnlocked
+      lifecycle_mutex_ must be locked by caller
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+ConnectionStatus_t UartBoardConnector<DataType>::DisconnectUnlocked() noexcept {
+  this->current_state_ = ConnectionStatus_t::DISCONNECTION_IN_PROGRESS;     //Send() refuses new parcels from now
+  sender_thread_.join_request.store(true, std::memory_order_relaxed);
+  receiver_thread_.join_request.store(true, std::memory_order_relaxed);
+  if(stop_event_ != nullptr) {
+    SetEvent(stop_event_);      //interrupts pending operations and idle waits of service threads
+  }
   StopSenderService();
   StopReceiverService();
   ReleaseCOMPort();
-  return ConnectionStatus_t::DISCONNECTED_OK;
+  return this->current_state_ = ConnectionStatus_t::DISCONNECTED_OK;
 }
 
 
@@ -226,10 +391,35 @@ ConnectionStatus_t UartBoardConnector<DataType>::Disconnect() noexcept {
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
-bool UartBoardConnector<DataType>::Send(const DataType data) {
+bool UartBoardConnector<DataType>::Send(DataType data) {
   if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK)
     return false;
-  return this->send_buffer_.Store(data);
+  return SendShared(MakeParcel<DataType>(std::move(data)));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::SendShared
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool UartBoardConnector<DataType>::SendShared(SharedParcel<DataType> parcel) {
+  return SendSlice(std::move(parcel), 0, WHOLE_PARCEL);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::SendSlice
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+bool UartBoardConnector<DataType>::SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) {
+  if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK || !parcel)
+    return false;
+  if(!this->send_buffer_.Store({ std::move(parcel), offset, length }))
+    return false;
+  SetEvent(send_event_);
+  return true;
 }
 
 
@@ -239,11 +429,21 @@ bool UartBoardConnector<DataType>::Send(const DataType data) {
 */
 template <typename DataType>
 optional<DataType> UartBoardConnector<DataType>::Receive() {
-  auto rx_data = this->receive_buffer_.Load();
-  if(rx_data != nullopt) {
-    this->receive_buffer_.ConfirmReception();
+  auto rx_data = ReceiveTimestamped();
+  if(rx_data == nullopt) {
+    return nullopt;
   }
-  return rx_data;
+  return std::move(rx_data->data);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::ReceiveTimestamped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+optional<TimestampedParcel<DataType>> UartBoardConnector<DataType>::ReceiveTimestamped() {
+  return this->receive_buffer_.Take();
 }
 
 
@@ -254,6 +454,13 @@ optional<DataType> UartBoardConnector<DataType>::Receive() {
 template <typename DataType>
 void UartBoardConnector<DataType>::SenderLoop() noexcept {
   auto& stop_request_atomic = sender_thread_.join_request;
+  std::vector<char> tx_scratch;     //storage for packed codec messages
+  OverlappedOperation write_operation;
+  if(!write_operation.Valid()) {
+    SenderLoopErrorHandler();
+    return;
+  }
+  
   while(!stop_request_atomic.load(std::memory_order_relaxed)) {
     /*  sender loop routine  */
     
@@ -261,11 +468,15 @@ void UartBoardConnector<DataType>::SenderLoop() noexcept {
       auto send_parcel = this->send_buffer_.Load();
   
       if(send_parcel){
-        const char* raw_str = Data(*send_parcel);
-        const int len = std::strlen(raw_str);
+        const std::string_view raw = codec::ToRaw(*send_parcel, tx_scratch);
+        const DWORD len = static_cast<DWORD>(raw.size());
+        if(!pacer_.Wait(len, stop_event_))
+          break;      //Disconnect() during pacing delay, parcel stays in queue
         DWORD bytes_written{};
-        bool send_result = WriteFile(handler_, raw_str, len, &bytes_written, nullptr);
-        if(send_result == false){
+        const BOOL started = WriteFile(handler_, raw.data(), len, nullptr, &write_operation.overlapped);
+        if(!CompleteOverlapped(started, write_operation, bytes_written)){
+          if(stop_request_atomic.load(std::memory_order_relaxed))
+            break;
           /* error handling */
           throw std::runtime_error("Error during sending parcel");
         }
@@ -282,7 +493,7 @@ void UartBoardConnector<DataType>::SenderLoop() noexcept {
     }
     
     /*   end of sender loop routine  */
-    std::this_thread::sleep_for(uart_settings_.send_loop_period);
+    WaitIdle(send_event_, uart_settings_.send_loop_period);     //new parcel wakes sender up at once
   }
   cout<<"Sender loop finished"<<endl;
 }
@@ -298,28 +509,73 @@ void UartBoardConnector<DataType>::ReceiverLoop() noexcept {
   
   DWORD actually_received;
   const DWORD max_bytes_to_read = uart_settings_.max_bytes_to_read_at_once;
-  char rx_buffer[max_bytes_to_read];
+  std::vector<char> rx_buffer(max_bytes_to_read);
+  codec::StreamDecoder<DataType> stream_decoder;
+  OverlappedOperation read_operation;
+  OverlappedOperation wait_operation;
+  if(!read_operation.Valid() || !wait_operation.Valid()) {
+    ReceiverLoopErrorHandler();
+    return;
+  }
+  
+    //driver reports arrival of data (EV_RXCHAR). Some virtual port drivers don't support it: they are polled
+  const bool wait_for_data = SetCommMask(handler_, EV_RXCHAR);
+  if(!wait_for_data) {
+    cout<<"Port does not report received data, it is polled every "<<uart_settings_.receive_loop_period.count()<<" ms"<<endl;
+  }
+  std::optional<TimePoint_t> arrival_time;      //when EV_RXCHAR was reported
   
   while(!stop_request_atomic.load(std::memory_order_relaxed)) {
     /*  receiver loop routine  */
     
     try{
+      DWORD errors = 0;
+      COMSTAT port_status{};
+      if(!ClearCommError(handler_, &errors, &port_status)) {
+        throw std::runtime_error("Error when getting COM port status");
+      }
       
-      bool read_result = ReadFile(handler_, rx_buffer, max_bytes_to_read, &actually_received, nullptr);
+      if(wait_for_data && port_status.cbInQue == 0) {
+          //completes at once if data has arrived after ClearCommError(): driver remembers the event
+        DWORD event_mask = 0;
+        DWORD unused;
+        const BOOL started = WaitCommEvent(handler_, &event_mask, &wait_operation.overlapped);
+        if(!CompleteOverlapped(started, wait_operation, unused)) {
+          if(stop_request_atomic.load(std::memory_order_relaxed))
+            break;
+          throw std::runtime_error("Error when waiting for COM port data");
+        }
+        arrival_time = Clock_t::now();
+        continue;
+      }
+      
+      const DWORD bytes_to_read = wait_for_data ? std::min<DWORD>(port_status.cbInQue, max_bytes_to_read) : max_bytes_to_read;
+      const BOOL started = ReadFile(handler_, rx_buffer.data(), bytes_to_read, nullptr, &read_operation.overlapped);
+      const bool read_result = CompleteOverlapped(started, read_operation, actually_received);
+        //as close to arrival as possible: time of the event, or of the read for data which was already waiting
+      const TimePoint_t timestamp = arrival_time ? *arrival_time : Clock_t::now();
+      arrival_time.reset();
       if(!read_result) {
+        if(stop_request_atomic.load(std::memory_order_relaxed))
+          break;
         throw std::runtime_error("Error during reading COM port");
       }
       if(actually_received > 0){
-        this->receive_buffer_.Store(Data(rx_buffer, actually_received));
+        stream_decoder.Feed(rx_buffer.data(), actually_received, [this, timestamp](DataType&& rx_data){
+          this->StoreReceived({ std::move(rx_data), timestamp });
+        });
         continue;
       }
+      if(wait_for_data || uart_settings_.low_latency) {
+        continue;     //next wait is for data, or ReadFile itself waits for data in low latency mode
+      }
     }  //try
     catch(...){
       ReceiverLoopErrorHandler();
     }
     
     /*   end of receiver loop routine  */
-    std::this_thread::sleep_for(uart_settings_.receive_loop_period);
+    WaitIdle(nullptr, uart_settings_.receive_loop_period);
   }
   cout<<"Receiver loop finished"<<endl;
 }
@@ -330,12 +586,23 @@ void UartBoardConnector<DataType>::ReceiverLoop() noexcept {
     --------------------------------------------------------------------------------------------------------------------
 */
 template <typename DataType>
-void UartBoardConnector<DataType>::SenderLoopErrorHandler(){
+void UartBoardConnector<DataType>::SenderLoopErrorHandler() noexcept {
   cout<<"Error in sender loop. Disconnection"<<endl;
   
 }
 
 
+/*  --------------------------------------------------------------------------------------------------------------------
+      UartBoardConnector::ReceiverLoopErrorHandler
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+void UartBoardConnector<DataType>::ReceiverLoopErrorHandler() noexcept {
+  cout<<"Error in receiver loop. Disconnection"<<endl;
+  
+}
+
+
 /*  --------------------------------------------------------------------------------------------------------------------
       UartBoardConnector::StartSenderService
     --------------------------------------------------------------------------------------------------------------------
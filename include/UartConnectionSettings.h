@@ -23,6 +23,7 @@ enum DataLength_t { FIVE_BITS = 5, SIX_BITS = 6, SEVEN_BITS = 7, EIGHT_BITS = 8
 enum Parity_t { UART_PARITY_NONE = 0, UART_PARITY_ODD = 1, UART_PARITY_EVEN = 2 };
 enum StopBits_t { STOP_ONE = 1, STOP_TWO = 2 };
 enum PortName_t { COM0, COM1, COM2, COM3, COM4, COM5, COM6 };
+enum FlowControl_t { FLOW_NONE = 0, FLOW_RTS_CTS = 1, FLOW_XON_XOFF = 2 };
 
 using Duration_t = std::chrono::duration<long long, std::milli>;
 using std::chrono::operator""ms;
@@ -36,11 +37,20 @@ const std::map<PortName_t, const std::string> PortNameMap = {   { COM0, "COM0" }
                                                                 { COM5, "COM5" },
                                                                 { COM6, "COM6" } };
                                                                   
-const std::string ConvertPortNameToStr(PortName_t pn) noexcept { 
+inline const std::string ConvertPortNameToStr(PortName_t pn) noexcept { 
   assert(PortNameMap.find(pn) != PortNameMap.end());
   return PortNameMap.at(pn); 
 }
 
+  //"COM12" -> "\\.\COM12". Ports above COM9 (and any other device) can be opened by CreateFile only via this namespace
+inline const std::string ConvertPortNameToDevicePath(const std::string& port_name) {
+  const std::string device_namespace = "\\\\.\\";
+  if(port_name.compare(0, device_namespace.size(), device_namespace) == 0) {
+    return port_name;
+  }
+  return device_namespace + port_name;
+}
+
 
 
 struct UartConnectionSettings : IConnectionSettings {
@@ -56,8 +66,11 @@ protected:
   constexpr static Duration_t DEFAULT_RECEIVE_LOOP_PERIOD = 200ms;
   constexpr static Duration_t DEFAULT_SEND_LOOP_PERIOD = 200ms;
   constexpr static int DEFAULT_MAX_BYTES_TO_READ_AT_ONCE = 100;
+  constexpr static FlowControl_t DEFAULT_FLOW_CONTROL = FLOW_NONE;
+  constexpr static int DEFAULT_QUEUE_SIZE = 0;        //driver default
 public:
   const PortName_t port;
+  std::string port_path;              //port to open: any port name ("COM27") or device path; for PortName_t it's "COM0".."COM6"
   const BaudRate_t baud;
   const DataLength_t length;
   const Parity_t parity;
@@ -67,6 +80,29 @@ public:
   Duration_t send_loop_period = DEFAULT_SEND_LOOP_PERIOD;
   int max_bytes_to_read_at_once = DEFAULT_MAX_BYTES_TO_READ_AT_ONCE;
   
+  FlowControl_t flow_control = DEFAULT_FLOW_CONTROL;
+  int input_queue_size = DEFAULT_QUEUE_SIZE;          //driver buffers, bytes (SetupComm). 0 - keep driver default
+  int output_queue_size = DEFAULT_QUEUE_SIZE;
+  bool purge_on_connect = false;                      //drop stale data from driver buffers when port is opened
+  
+    //receiver waits for data reported by the driver; receive_loop_period is the polling period for drivers,
+    //which don't report it. Low latency mode: polling ReadFile returns as soon as any byte arrives (or after
+    //receive_loop_period), FTDI latency timer is shortened. Reads and writes are overlapped, so a pending read
+    //does not delay sending.
+  bool low_latency = false;
+  
+    //FTDI adapters pass received bytes to host when their buffer is full or latency timer expires (16 ms by default).
+    //In low latency mode the timer of FTDI port is set to this value, ms (1..255; 0 - don't touch). The timer is
+    //a driver setting in device registry key: changing it requires administrator rights and takes effect
+    //after the adapter is re-plugged. See ApplyFtdiLatencyTimer()
+  unsigned ftdi_latency_timer = 1;
+  
+    //pacing of outgoing traffic (token buckets). Rate 0 - no limit
+  double pacing_bytes_per_second = 0;
+  double pacing_bytes_burst = 64;
+  double pacing_parcels_per_second = 0;
+  double pacing_parcels_burst = 1;
+  
 //for WinApi
 public:
   COMMTIMEOUTS winapi_commtimeouts = DEFAULT_COMMTIMEOUTS;
@@ -77,17 +113,34 @@ public:
                           DataLength_t l   = DEFAULT_DATA_LENGTH, 
                           Parity_t p       = DEFAULT_PARITY, 
                           StopBits_t s     = DEFAULT_STOP_BITS) noexcept :
-                          port(pn), baud(b), length(l), parity(p), stop_bits(s) {  cout<<"UartConnectionSettings created "<<endl; };
+                          port(pn), port_path(ConvertPortNameToStr(pn)), baud(b), length(l), parity(p), stop_bits(s) {  cout<<"UartConnectionSettings created "<<endl; };
+
+  UartConnectionSettings(  const std::string& path,
+                          BaudRate_t b     = DEFAULT_BAUD_RATE, 
+                          DataLength_t l   = DEFAULT_DATA_LENGTH, 
+                          Parity_t p       = DEFAULT_PARITY, 
+                          StopBits_t s     = DEFAULT_STOP_BITS) :
+                          port(DEFAULT_PORT_NAME), port_path(path), baud(b), length(l), parity(p), stop_bits(s) {  cout<<"UartConnectionSettings created "<<endl; };
                           
   virtual ~UartConnectionSettings() { cout<<"~UartConnectionSettings"<<endl; };
   
+public:
+    //copy of these settings for another port (e.g. for a board found by SerialPortWatcher)
+  UartConnectionSettings WithPort(const std::string& path) const {
+    UartConnectionSettings copy(*this);
+    copy.port_path = path;
+    return copy;
+  }
+
 public:
   void Dump() const override  {
-    cout<<"PortName = "<<ConvertPortNameToStr(port)<<endl;  
+    cout<<"PortName = "<<port_path<<endl;  
     cout<<"BaudRate = "<<baud<<endl;
     cout<<"Length = "<<length<<" bits"<<endl;
     cout<<"Parity = "<<parity<<endl;
     cout<<"StopBits = "<<stop_bits<<" bits"<<endl;
+    cout<<"FlowControl = "<<flow_control<<endl;
+    cout<<"LowLatency = "<<low_latency<<endl;
   };
 };  
 
@@ -0,0 +1,191 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  BoardGroup: Broadcast and Scatter over in-memory boards, bring-up of boards, access to boards by key
+*/
+
+#include <vector>
+#include <string>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+#include "FakeBoardConnector.h"
+
+using namespace board_connect;
+
+
+std::optional<std::string> ReceiveWithTimeout(Board<std::string>& board, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while(std::chrono::steady_clock::now() < deadline) {
+    auto rx_data = board.Receive();
+    if(rx_data)
+      return rx_data;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return std::nullopt;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Each board gets its own part of one shared buffer
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void ScatterSendsSlices() {
+  constexpr std::size_t BOARDS_COUNT = 4;
+  test::FakeConnectionSettings settings;
+  test::FakeBoardConnectorFactory<std::string> factory;
+  BoardGroup<std::string> group;
+  for(std::size_t i = 0; i < BOARDS_COUNT; ++i) {
+    group.Add(settings, factory);
+  }
+  CHECK(group.ConnectAll().AllConnected());
+
+  const SharedParcel<std::string> frame = MakeParcel<std::string>("AAAABBBBCCCCDD");
+  const std::vector<ParcelSlice> slices = { {0, 4}, {4, 4}, {8, 4}, {12, WHOLE_PARCEL} };
+  CHECK(group.Scatter(frame, slices));
+  CHECK(ReceiveWithTimeout(*group[0]) == std::string("AAAA"));
+  CHECK(ReceiveWithTimeout(*group[1]) == std::string("BBBB"));
+  CHECK(ReceiveWithTimeout(*group[2]) == std::string("CCCC"));
+  CHECK(ReceiveWithTimeout(*group[3]) == std::string("DD"));
+
+  CHECK(!group.Scatter(frame, { {0, 4} }));      //one slice per board is required
+  CHECK(!group.Scatter(nullptr, slices));
+
+    //buffer is released by the last send queue
+  CHECK(frame.use_count() == 1);
+}
+
+
+void BroadcastSharesParcel() {
+  test::FakeConnectionSettings settings;
+  test::FakeBoardConnectorFactory<std::string> factory;
+  BoardGroup<std::string> group;
+  group.Add(settings, factory);
+  group.Add(settings, factory);
+  CHECK(group.ConnectAll().AllConnected());
+
+  CHECK(group.Broadcast(std::string("to everyone")));
+  CHECK(ReceiveWithTimeout(*group[0]) == std::string("to everyone"));
+  CHECK(ReceiveWithTimeout(*group[1]) == std::string("to everyone"));
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Boards added for new ports are connected by key, removed board is disconnected
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void ConnectAndRemoveByKey() {
+  test::FakeConnectionSettings settings;
+  test::FakeBoardConnectorFactory<std::string> factory;
+  BoardGroup<std::string> group;
+  group.Add(settings, factory, "USB\\VID_0403&PID_6001\\A1");
+  group.Add(settings, factory, "COM7");
+  Board<std::string>& third = group.Add(settings, factory, "USB\\VID_0403&PID_6001\\A3");
+  CHECK(group.Contains("COM7"));
+  CHECK(!group.Contains("COM8"));
+
+  const ConnectAllReport report = group.Connect({ "COM7", "USB\\VID_0403&PID_6001\\A3" });
+  CHECK(report.boards.size() == 2);
+  CHECK(report.AllConnected());
+  CHECK(report.boards[0].key == "COM7");
+  CHECK(!(group[0]->Status() == ConnectionStatus_t::CONNECTED_OK));
+  CHECK(third.Status() == ConnectionStatus_t::CONNECTED_OK);
+
+  CHECK(group.Remove("COM7"));
+  CHECK(!group.Remove("COM7"));
+  CHECK(group.Size() == 2);
+  CHECK(!group.Contains("COM7"));
+  CHECK(group[1].get() == &third);       //other boards stay in place
+  CHECK(third.Send("still here"));
+  CHECK(ReceiveWithTimeout(third) == std::string("still here"));
+
+    //board found by key stays alive after it's removed from group
+  const auto found = group.Find("USB\\VID_0403&PID_6001\\A1");
+  CHECK(found != nullptr);
+  CHECK(group.Find("COM7") == nullptr);
+  CHECK(group.Remove("USB\\VID_0403&PID_6001\\A1"));
+  CHECK(!(found->Status() == ConnectionStatus_t::CONNECTED_OK));
+  CHECK(group[0].get() == &third);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      StartConnect returns at once, bring-up threads are joined by WaitBringUp() and by destructor of group
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void StartConnectDoesNotBlock() {
+  test::FakeConnectionSettings slow_settings;
+  slow_settings.connect_delay = std::chrono::milliseconds(300);
+  test::FakeBoardConnectorFactory<std::string> factory;
+  {
+    BoardGroup<std::string> group;
+    group.Add(slow_settings, factory, "slow 1");
+    group.Add(slow_settings, factory, "slow 2");
+
+    const auto start = std::chrono::steady_clock::now();
+    group.StartConnect({ "slow 1", "slow 2" });
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200));
+    group.WaitBringUp();
+    CHECK(group[0]->Status() == ConnectionStatus_t::CONNECTED_OK);
+    CHECK(group[1]->Status() == ConnectionStatus_t::CONNECTED_OK);
+  }
+
+  std::shared_ptr<Board<std::string>> board;
+  {
+    BoardGroup<std::string> group;
+    group.Add(slow_settings, factory, "slow");
+    board = group.Find("slow");
+    group.StartConnect({ "slow" });
+  }       //destructor waits for Connect() in progress
+  CHECK(board->Status() == ConnectionStatus_t::CONNECTED_OK);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      ConnectAll returns by timeout, slow board is connected in background, connected boards are skipped
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void ConnectAllKeepsTimeout() {
+  test::FakeConnectionSettings fast_settings;
+  test::FakeConnectionSettings slow_settings;
+  slow_settings.connect_delay = std::chrono::milliseconds(1500);
+  test::FakeBoardConnectorFactory<std::string> factory;
+  BoardGroup<std::string> group;
+  group.Add(fast_settings, factory, "fast 1");
+  Board<std::string>& slow = group.Add(slow_settings, factory, "slow");
+  group.Add(fast_settings, factory, "fast 2");
+
+  const ConnectAllReport report = group.ConnectAll(8, std::chrono::milliseconds(300));
+  CHECK(report.elapsed < std::chrono::milliseconds(1000));
+  CHECK(report.connected_count == 2);
+  CHECK(report.boards[1].key == "slow");
+  CHECK(report.boards[1].timed_out);
+  CHECK(!report.boards[0].timed_out && !report.boards[2].timed_out);
+
+    //late success is kept
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while(!(slow.Status() == ConnectionStatus_t::CONNECTED_OK) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CHECK(slow.Status() == ConnectionStatus_t::CONNECTED_OK);
+
+  const ConnectAllReport second_report = group.ConnectAll(8, std::chrono::milliseconds(300));
+  CHECK(second_report.AllConnected());
+  CHECK(second_report.elapsed < std::chrono::milliseconds(100));
+  for(const auto& result : second_report.boards) {
+    CHECK(result.already_connected);
+  }
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  ScatterSendsSlices();
+  BroadcastSharesParcel();
+  ConnectAndRemoveByKey();
+  ConnectAllKeepsTimeout();
+  StartConnectDoesNotBlock();
+  return test::Result("BoardGroupTest");
+}
@@ -0,0 +1,88 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  ClockCorrelator: offset and drift of synthetic board clock are recovered, window slides,
+  wrapping counter is unwrapped
+*/
+
+#include <cmath>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+
+using namespace board_connect;
+
+
+constexpr long double TICKS_PER_SECOND = 1.0e6L;
+constexpr long double OFFSET_S = 0.25L;           //host time at board time 0, relative to host_origin
+constexpr long double DRIFT = 1.00005L;           //board clock is 50 ppm slow
+
+const TimePoint_t host_origin = Clock_t::now();
+
+TimePoint_t TrueHostTime(long long board_ticks) {
+  const std::chrono::duration<long double> host_seconds{ OFFSET_S + DRIFT * (board_ticks / TICKS_PER_SECOND) };
+  return host_origin + std::chrono::duration_cast<Clock_t::duration>(host_seconds);
+}
+
+double ErrorSeconds(TimePoint_t estimated, TimePoint_t expected) {
+  return std::abs(std::chrono::duration<double>(estimated - expected).count());
+}
+
+
+void NoEstimateBeforeTwoSamples() {
+  ClockCorrelator correlator(TICKS_PER_SECOND);
+  CHECK(correlator.ToHostTime(0) == std::nullopt);
+  correlator.AddSample(0, TrueHostTime(0));
+  CHECK(correlator.ToHostTime(0) == std::nullopt);
+  correlator.AddSample(1000, TrueHostTime(1000));
+  CHECK(correlator.ToHostTime(0) != std::nullopt);
+}
+
+
+  //samples every 10 ms of board time with +-20 us of receive jitter; window of 256 slides over 2000 samples
+void RecoversOffsetAndDrift() {
+  ClockCorrelator correlator(TICKS_PER_SECOND, 256);
+  const long long start_ticks = 1000LL * 1000000;
+  long long ticks = start_ticks;
+  for(int i = 0; i < 2000; ++i, ticks += 10000) {
+    const auto jitter = std::chrono::microseconds((i * 7919) % 41 - 20);
+    correlator.AddSample(ticks, TrueHostTime(ticks) + jitter);
+  }
+  CHECK(std::abs(correlator.Drift() - static_cast<double>(DRIFT)) < 2e-6);
+  CHECK(ErrorSeconds(*correlator.ToHostTime(ticks), TrueHostTime(ticks)) < 50e-6);
+  CHECK(ErrorSeconds(*correlator.ToHostTime(ticks - 1000000), TrueHostTime(ticks - 1000000)) < 50e-6);
+
+    //exact samples: running sums of small window over many updates stay exact
+  ClockCorrelator exact(TICKS_PER_SECOND, 16);
+  for(long long t = start_ticks; t < start_ticks + 100000LL * 1000; t += 1000) {
+    exact.AddSample(t, TrueHostTime(t));
+  }
+  CHECK(std::abs(exact.Drift() - static_cast<double>(DRIFT)) < 1e-9);
+  CHECK(ErrorSeconds(*exact.ToHostTime(start_ticks), TrueHostTime(start_ticks)) < 1e-6);
+}
+
+
+  //32-bit counter at 1 MHz wraps every ~71.6 minutes, samples go across the wrap
+void UnwrapsCounter() {
+  constexpr long long PERIOD = 1LL << 32;
+  ClockCorrelator correlator(TICKS_PER_SECOND, 64, 32);
+  const long long start_ticks = PERIOD - 5000000;
+  long long ticks = start_ticks;
+  for(int i = 0; i < 100; ++i, ticks += 100000) {
+    correlator.AddSample(ticks % PERIOD, TrueHostTime(ticks));
+  }
+  CHECK(std::abs(correlator.Drift() - static_cast<double>(DRIFT)) < 1e-9);
+  CHECK(ErrorSeconds(*correlator.ToHostTime(ticks % PERIOD), TrueHostTime(ticks)) < 1e-6);
+  CHECK(ErrorSeconds(*correlator.ToHostTime((PERIOD - 1000) % PERIOD), TrueHostTime(PERIOD - 1000)) < 1e-6);
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  NoEstimateBeforeTwoSamples();
+  RecoversOffsetAndDrift();
+  UnwrapsCounter();
+  return test::Result("ClockCorrelatorTest");
+}
@@ -0,0 +1,125 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  DecodePipeline: framing of UART-like chunks, order of decoded frames, Submit() after pool shutdown
+*/
+
+#include <string>
+#include <vector>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+#include "FakeBoardConnector.h"
+
+using namespace board_connect;
+
+
+std::vector<std::string> CollectFrames(std::function<void(const std::string&, const std::function<void(std::string)>&)> framer,
+                                      const std::vector<std::string>& chunks) {
+  std::vector<std::string> frames;
+  for(const auto& chunk : chunks) {
+    framer(chunk, [&frames](std::string frame){ frames.push_back(std::move(frame)); });
+  }
+  return frames;
+}
+
+
+void Framers() {
+  CHECK((CollectFrames(FixedSizeFramer(4), {"ab", "cdefg", "h", "ijklmnop", "q"}) ==
+         std::vector<std::string>{"abcd", "efgh", "ijkl", "mnop"}));
+  CHECK((CollectFrames(DelimiterFramer(';'), {"one;tw", "o;", ";three", ";fo"}) ==
+         std::vector<std::string>{"one", "two", "three"}));
+    //frame without delimiter longer than limit is dropped, stream recovers at the next delimiter
+  CHECK((CollectFrames(DelimiterFramer(';', 4), {"abcdefgh", "ij;ok;"}) ==
+         std::vector<std::string>{"ok"}));
+}
+
+
+  //fake connector echoes each Send() as one parcel, so chunks cut frames at arbitrary positions
+void FramedOrderFromBoard() {
+  constexpr int FRAMES_COUNT = 2000;
+  WorkStealingPool pool(4);
+  DecodePipeline<int, std::string> pipeline([](const std::string& frame){ return std::stoi(frame); },
+                                            pool, DelimiterFramer('\n'));
+
+  test::FakeConnectionSettings settings;
+  Board<std::string> board(settings, test::FakeBoardConnectorFactory<std::string>());
+  CHECK(board.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  pipeline.Start(board);
+
+  std::string stream;
+  for(int i = 0; i < FRAMES_COUNT; ++i) {
+    stream += std::to_string(i) + "\n";
+  }
+  for(std::size_t position = 0, length = 1; position < stream.size(); position += length, length = length % 13 + 1) {
+    board.Send(stream.substr(position, length));
+  }
+
+  int expected = 0;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while(expected < FRAMES_COUNT && std::chrono::steady_clock::now() < deadline) {
+    auto decoded = pipeline.Receive();
+    if(!decoded) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    if(*decoded != expected)
+      break;
+    ++expected;
+  }
+  CHECK(expected == FRAMES_COUNT);
+  pipeline.Stop();
+  board.Disconnect();
+}
+
+
+  //frames submitted after Shutdown() are refused; pipeline destructor does not wait for them
+void SubmitAfterShutdown() {
+  WorkStealingPool pool(2);
+  std::atomic<int> executed{0};
+  CHECK(pool.Submit([&executed]{ ++executed; }));
+  pool.Shutdown();
+  CHECK(executed == 1);
+  CHECK(!pool.Submit([&executed]{ ++executed; }));
+  CHECK(executed == 1);
+
+  {
+    DecodePipeline<int, std::string> pipeline([](const std::string& frame){ return std::stoi(frame); }, pool);
+    CHECK(!pipeline.Submit("1"));
+    CHECK(!pipeline.Receive());
+  }
+}
+
+
+void ParallelSubmitters() {
+  constexpr int SUBMITTERS_COUNT = 4;
+  constexpr int TASKS_PER_SUBMITTER = 20000;
+  std::atomic<int> executed{0};
+  {
+    WorkStealingPool pool(4);
+    std::vector<std::thread> submitters;
+    for(int i = 0; i < SUBMITTERS_COUNT; ++i) {
+      submitters.emplace_back([&pool, &executed]{
+        for(int task = 0; task < TASKS_PER_SUBMITTER; ++task) {
+          pool.Submit([&executed]{ ++executed; });
+        }
+      });
+    }
+    for(auto& submitter : submitters) {
+      submitter.join();
+    }
+  }   //Shutdown() executes remaining tasks
+  CHECK(executed == SUBMITTERS_COUNT * TASKS_PER_SUBMITTER);
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  Framers();
+  FramedOrderFromBoard();
+  SubmitAfterShutdown();
+  ParallelSubmitters();
+  return test::Result("DecodePipelineTest");
+}
@@ -0,0 +1,131 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Dispatcher: WORKER handlers stay on worker threads after Stop() / Start(), blocked key does not delay
+  other keys, order of parcels with the same key is kept by the pool
+*/
+
+#include <string>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+#include "FakeBoardConnector.h"
+
+using namespace board_connect;
+
+
+struct HandlerThreads{
+  std::mutex ids_mutex;
+  std::thread::id inline_handler;
+  std::thread::id worker_handler;
+  std::atomic<int> worker_calls{0};
+};
+
+
+bool WaitFor(const std::atomic<int>& counter, int value) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while(counter < value && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return counter >= value;
+}
+
+
+void WorkerModeSurvivesRestart() {
+  HandlerThreads threads;
+  Dispatcher<std::string> dispatcher;
+  CHECK(dispatcher.Register('i', [&threads](const std::string&){
+    const std::lock_guard<std::mutex> lock(threads.ids_mutex);
+    threads.inline_handler = std::this_thread::get_id();
+  }));
+  CHECK(dispatcher.Register('w', [&threads](const std::string&){
+    {
+      const std::lock_guard<std::mutex> lock(threads.ids_mutex);
+      threads.worker_handler = std::this_thread::get_id();
+    }
+    ++threads.worker_calls;
+  }, DispatchMode_t::WORKER));
+
+  test::FakeConnectionSettings settings;
+  Board<std::string> board(settings, test::FakeBoardConnectorFactory<std::string>());
+  CHECK(board.Connect() == ConnectionStatus_t::CONNECTED_OK);
+
+  for(int round = 1; round <= 2; ++round) {
+    dispatcher.Start(board);
+    board.Send("i");
+    board.Send("w");
+    CHECK(WaitFor(threads.worker_calls, round));
+    dispatcher.Stop();
+
+    const std::lock_guard<std::mutex> lock(threads.ids_mutex);
+    CHECK(threads.worker_handler != std::thread::id());
+    CHECK(threads.worker_handler != threads.inline_handler);    //not in poll thread
+    CHECK(threads.worker_handler != std::this_thread::get_id());
+  }
+
+    //workers are stopped: parcel is refused, handler is not called inline
+  CHECK(!dispatcher.Dispatch("w"));
+  CHECK(threads.worker_calls == 2);
+  CHECK(dispatcher.Dispatch("i"));
+}
+
+
+void BlockedKeyDoesNotDelayOthers() {
+  std::atomic<int> blocked_calls{0};
+  std::atomic<int> other_calls{0};
+  std::atomic_bool release{false};
+  Dispatcher<std::string> dispatcher(2);
+  CHECK(dispatcher.Register('a', [&](const std::string&){
+    ++blocked_calls;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(!release && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }, DispatchMode_t::WORKER));
+  CHECK(dispatcher.Register('b', [&](const std::string&){ ++other_calls; }, DispatchMode_t::WORKER));
+
+  CHECK(dispatcher.Dispatch("a1"));
+  CHECK(WaitFor(blocked_calls, 1));
+  CHECK(dispatcher.Dispatch("a2"));       //waits behind a1: the same key is never handled by two threads
+  for(int i = 0; i < 10; ++i) {
+    CHECK(dispatcher.Dispatch("b"));
+  }
+  CHECK(WaitFor(other_calls, 10));
+  CHECK(blocked_calls == 1);
+
+  release = true;
+  CHECK(WaitFor(blocked_calls, 2));
+  dispatcher.Stop();
+}
+
+
+void OrderIsKeptPerKey() {
+  constexpr int PARCELS_COUNT = 2000;
+  std::vector<int> received[3];
+  Dispatcher<std::string> dispatcher(4);
+  for(int key = 0; key < 3; ++key) {
+    CHECK(dispatcher.Register('x' + key, [&received, key](const std::string& parcel){
+      received[key].push_back(std::stoi(parcel.substr(1)));      //keys are handled by one thread at a time
+    }, DispatchMode_t::WORKER));
+  }
+  for(int i = 0; i < PARCELS_COUNT; ++i) {
+    CHECK(dispatcher.Dispatch(std::string(1, static_cast<char>('x' + i % 3)) + std::to_string(i)));
+  }
+  dispatcher.Stop();      //remaining parcels are handled before workers exit
+
+  for(int key = 0; key < 3; ++key) {
+    CHECK(received[key].size() == static_cast<std::size_t>((PARCELS_COUNT - key + 2) / 3));
+    CHECK(std::is_sorted(received[key].begin(), received[key].end()));
+  }
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  WorkerModeSurvivesRestart();
+  BlockedKeyDoesNotDelayOthers();
+  OrderIsKeptPerKey();
+  return test::Result("DispatcherTest");
+}
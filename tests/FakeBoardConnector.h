@@ -0,0 +1,142 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  FakeBoardConnector header
+  In-memory connector for tests and benchmarks: every parcel sent is echoed back into receive buffer
+  by its service thread, as if the board answered with the same parcel.
+*/
+
+#ifndef FAKE_BOARD_CONNECTOR_H
+#define FAKE_BOARD_CONNECTOR_H
+
+#include "Declarations.h"
+#include "IBoardConnector.h"
+#include "MessageCodec.h"
+
+namespace board_connect {
+
+namespace test {
+
+
+struct FakeConnectionSettings : IConnectionSettings {
+  std::chrono::milliseconds connect_delay{0};       //imitates time of opening a device
+  std::chrono::microseconds idle_period{100};       //sleep of service thread when send queue is empty
+
+  void Dump() const override {
+    cout<<"FakeConnection: connect delay = "<<connect_delay.count()<<" ms"<<endl;
+  }
+};
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      FakeBoardConnector
+    --------------------------------------------------------------------------------------------------------------------
+*/
+template <typename DataType>
+class FakeBoardConnector : public IBoardConnector<DataType> {
+
+  const FakeConnectionSettings settings_;
+
+  struct ThreadWrapper{
+    thread th;
+    atomic_bool join_request;
+  };
+  ThreadWrapper echo_thread_;
+
+  std::mutex lifecycle_mutex_;
+  std::vector<char> tx_scratch_;
+
+private:
+  void EchoLoop() noexcept {
+    while(!echo_thread_.join_request.load(std::memory_order_relaxed)) {
+      auto parcel = this->send_buffer_.Load();
+      if(parcel) {
+        const std::string_view raw = codec::ToRaw(*parcel, tx_scratch_);
+        auto echo = codec::FromRaw<DataType>(raw.data(), raw.size());
+        if(echo) {
+          this->StoreReceived({ std::move(*echo), Clock_t::now() });
+        }
+        this->send_buffer_.ConfirmReception();
+        continue;
+      }
+      std::this_thread::sleep_for(settings_.idle_period);
+    }
+  }
+
+  ConnectionStatus_t DisconnectUnlocked() noexcept {
+    this->current_state_ = ConnectionStatus_t::DISCONNECTION_IN_PROGRESS;
+    echo_thread_.join_request.store(true, std::memory_order_relaxed);
+    if(echo_thread_.th.joinable()) {
+      echo_thread_.th.join();
+    }
+    return this->current_state_ = ConnectionStatus_t::DISCONNECTED_OK;
+  }
+
+public:
+  explicit FakeBoardConnector(const IConnectionSettings& settings)
+    : settings_(static_cast<const FakeConnectionSettings&>(settings)) {}
+  ~FakeBoardConnector() override { Disconnect(); }
+
+public:
+  ConnectionStatus_t Connect() override {
+    const std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    DisconnectUnlocked();
+    this->current_state_ = ConnectionStatus_t::CONNECTION_IN_PROGRESS;
+    std::this_thread::sleep_for(settings_.connect_delay);
+    echo_thread_.join_request.store(false, std::memory_order_relaxed);
+    echo_thread_.th = thread{&FakeBoardConnector<DataType>::EchoLoop, this};
+    return this->current_state_ = ConnectionStatus_t::CONNECTED_OK;
+  }
+
+  ConnectionStatus_t Status() noexcept override { return this->current_state_; }
+
+  ConnectionStatus_t Disconnect() noexcept override {
+    const std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    return DisconnectUnlocked();
+  }
+
+  bool Send(DataType data) override {
+    if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK)
+      return false;
+    return SendShared(MakeParcel<DataType>(std::move(data)));
+  }
+
+  bool SendShared(SharedParcel<DataType> parcel) override {
+    return SendSlice(std::move(parcel), 0, WHOLE_PARCEL);
+  }
+
+  bool SendSlice(SharedParcel<DataType> parcel, std::size_t offset, std::size_t length) override {
+    if(this->current_state_ != ConnectionStatus_t::CONNECTED_OK || !parcel)
+      return false;
+    return this->send_buffer_.Store({ std::move(parcel), offset, length });
+  }
+
+  std::optional<DataType> Receive() override {
+    auto rx_data = ReceiveTimestamped();
+    if(!rx_data)
+      return std::nullopt;
+    return std::move(rx_data->data);
+  }
+
+  std::optional<TimestampedParcel<DataType>> ReceiveTimestamped() override {
+    return this->receive_buffer_.Take();
+  }
+};
+
+
+template <typename DataType>
+class FakeBoardConnectorFactory : public IBoardConnectorFactory<DataType> {
+public:
+  IBoardConnector_up<DataType> MakeBoardConnector(const IConnectionSettings& connection_settings) const override {
+    return std::make_unique<FakeBoardConnector<DataType>>(connection_settings);
+  }
+};
+
+
+}  //test
+
+}  //board_connect
+
+#endif  //FAKE_BOARD_CONNECTOR_H
@@ -0,0 +1,93 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Pacer: rates in bytes/s and parcels/s are kept, burst is sent at once, waiting is interrupted by stop event,
+  Reset() refills buckets. Bounds of timing are loose, test runs on loaded machines
+*/
+
+#include "BoardConnect.h"
+#include "Pacer.h"
+#include "TestCheck.h"
+
+using namespace board_connect;
+
+
+double SecondsToSend(Pacer& pacer, std::size_t parcels_count, std::size_t parcel_size) {
+  const auto start = Clock_t::now();
+  for(std::size_t i = 0; i < parcels_count; ++i) {
+    CHECK(pacer.Wait(parcel_size));
+  }
+  return std::chrono::duration<double>(Clock_t::now() - start).count();
+}
+
+
+  //4000 bytes at 10000 B/s, the first 100 bytes are burst: ~0.39 s
+void ByteRateIsKept() {
+  Pacer pacer(10000, 100, 0, 1);
+  const double seconds = SecondsToSend(pacer, 40, 100);
+  CHECK(seconds > 0.3);
+  CHECK(seconds < 2.0);
+}
+
+
+  //30 parcels at 100 parcels/s, whatever their size: ~0.29 s
+void ParcelRateIsKept() {
+  Pacer pacer(0, 1, 100, 1);
+  const double seconds = SecondsToSend(pacer, 30, 1000);
+  CHECK(seconds > 0.2);
+  CHECK(seconds < 2.0);
+}
+
+
+  //full buckets let burst out without waiting, the next parcel waits for refill
+void BurstGoesAtOnce() {
+  Pacer pacer(1000, 5000, 10, 50);
+  CHECK(SecondsToSend(pacer, 50, 100) < 0.5);      //5 s worth of bytes and parcels
+  CHECK(SecondsToSend(pacer, 1, 100) > 0.05);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      At 1 byte/s the second parcel would wait for ~100 s, stop event ends waiting at once
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void StopEventInterruptsWait() {
+  Pacer pacer(1, 1, 0, 1);
+  const Handler stop_event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+  CHECK(stop_event != nullptr);
+
+  CHECK(pacer.Wait(100, stop_event));        //full bucket: parcel is sent at once and leaves bucket in debt
+
+  thread stopper([stop_event]{
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    SetEvent(stop_event);
+  });
+  const auto start = Clock_t::now();
+  CHECK(!pacer.Wait(100, stop_event));
+  CHECK(Clock_t::now() - start < std::chrono::seconds(5));
+  stopper.join();
+  CloseHandle(stop_event);
+}
+
+
+void ResetForgetsDebt() {
+  Pacer pacer(1, 1, 0, 1);
+  CHECK(pacer.Wait(100));
+  pacer.Reset();
+  const auto start = Clock_t::now();
+  CHECK(pacer.Wait(100));
+  CHECK(Clock_t::now() - start < std::chrono::seconds(1));
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  ByteRateIsKept();
+  ParcelRateIsKept();
+  BurstGoesAtOnce();
+  StopEventInterruptsWait();
+  ResetForgetsDebt();
+  return test::Result("PacerTest");
+}
@@ -0,0 +1,170 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  ReliableBoardConnector over LoopbackWire: delivery under loss and corruption, reconnection of one side
+*/
+
+#include <vector>
+#include <string>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+
+using namespace board_connect;
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Two reliable boards on two ends of one wire
+    --------------------------------------------------------------------------------------------------------------------
+*/
+struct ReliablePair{
+  std::shared_ptr<loopback::LoopbackWire> wire = std::make_shared<loopback::LoopbackWire>();
+  loopback::LoopbackConnectionSettings link_a{wire, loopback::END_A};
+  loopback::LoopbackConnectionSettings link_b{wire, loopback::END_B};
+  loopback::LoopbackBoardConnectorFactory<DefaultDataType> link_factory;
+  Board<std::string> a;
+  Board<std::string> b;
+
+  ReliablePair(const reliable::ReliableConnectionSettings& settings, std::size_t max_chunk_size)
+    : a(settings, reliable::ReliableBoardConnectorFactory<std::string>(WithChunks(link_a, max_chunk_size), link_factory)),
+      b(settings, reliable::ReliableBoardConnectorFactory<std::string>(WithChunks(link_b, max_chunk_size), link_factory)) {}
+
+  static const loopback::LoopbackConnectionSettings& WithChunks(loopback::LoopbackConnectionSettings& link, std::size_t max_chunk_size) {
+    link.max_chunk_size = max_chunk_size;
+    return link;
+  }
+};
+
+
+  //receives count parcels or gives up after timeout
+std::vector<std::string> ReceiveAll(Board<std::string>& board, std::size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(20)) {
+  std::vector<std::string> received;
+  const auto deadline = Clock_t::now() + timeout;
+  while(received.size() < count && Clock_t::now() < deadline) {
+    auto rx_data = board.Receive();
+    if(rx_data) {
+      received.push_back(std::move(*rx_data));
+      continue;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return received;
+}
+
+
+std::vector<std::string> Numbered(const std::string& prefix, std::size_t count) {
+  std::vector<std::string> parcels;
+  for(std::size_t i = 0; i < count; ++i) {
+    parcels.push_back(prefix + std::to_string(i));
+  }
+  return parcels;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Every parcel is delivered once and in order in both directions, though frames are lost and damaged
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void DeliveryUnderFaults() {
+  reliable::ReliableConnectionSettings settings;
+  settings.window_size = 16;
+  settings.initial_rto = std::chrono::milliseconds(50);
+  settings.max_retransmits = 30;
+  settings.inject_loss_probability = 0.1;
+  settings.inject_corruption_probability = 0.1;
+  ReliablePair pair(settings, 7);
+
+  CHECK(pair.a.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(pair.b.Connect() == ConnectionStatus_t::CONNECTED_OK);
+
+  constexpr std::size_t PARCELS_COUNT = 500;
+  const auto from_a = Numbered("a", PARCELS_COUNT);
+  const auto from_b = Numbered("b", PARCELS_COUNT);
+  for(std::size_t i = 0; i < PARCELS_COUNT; ++i) {
+    CHECK(pair.a.Send(from_a[i]));
+    CHECK(pair.b.Send(from_b[i]));
+  }
+  CHECK(ReceiveAll(pair.b, PARCELS_COUNT) == from_a);
+  CHECK(ReceiveAll(pair.a, PARCELS_COUNT) == from_b);
+  CHECK(pair.a.Status() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(pair.b.Status() == ConnectionStatus_t::CONNECTED_OK);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      One side is reconnected (e.g. host application restarted), the other one keeps its state.
+      Traffic in both directions must go on after the handshake
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void ReconnectOneSide() {
+  reliable::ReliableConnectionSettings settings;
+  settings.initial_rto = std::chrono::milliseconds(50);
+  ReliablePair pair(settings, 5);
+
+  CHECK(pair.a.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(pair.b.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  for(const auto& parcel : Numbered("before", 10)) {
+    pair.a.Send(parcel);
+    pair.b.Send(parcel);
+  }
+  CHECK(ReceiveAll(pair.b, 10).size() == 10);
+  CHECK(ReceiveAll(pair.a, 10).size() == 10);
+
+    //reconnected side sends first
+  CHECK(pair.a.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  const auto after_a = Numbered("after a", 10);
+  for(const auto& parcel : after_a) {
+    CHECK(pair.a.Send(parcel));
+  }
+  CHECK(ReceiveAll(pair.b, 10) == after_a);
+
+    //side, which was not reconnected, sends to the new incarnation of its peer
+  const auto after_b = Numbered("after b", 10);
+  for(const auto& parcel : after_b) {
+    CHECK(pair.b.Send(parcel));
+  }
+  CHECK(ReceiveAll(pair.a, 10) == after_b);
+
+    //reconnected side does not send at all, its peer sends right away
+  CHECK(pair.b.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  const auto after_reconnect_b = Numbered("after reconnect of b", 10);
+  for(const auto& parcel : after_reconnect_b) {
+    CHECK(pair.a.Send(parcel));
+  }
+  CHECK(ReceiveAll(pair.b, 10) == after_reconnect_b);
+
+  CHECK(pair.a.Status() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(pair.b.Status() == ConnectionStatus_t::CONNECTED_OK);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Peer, which never answers, is reported as lost: SYN is retransmitted max_retransmits times
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void SilentPeerIsLost() {
+  reliable::ReliableConnectionSettings settings;
+  settings.initial_rto = std::chrono::milliseconds(10);
+  settings.max_rto = std::chrono::milliseconds(20);
+  settings.max_retransmits = 3;
+  ReliablePair pair(settings, 0);
+
+  CHECK(pair.a.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(pair.a.Send("nobody listens"));
+  const auto deadline = Clock_t::now() + std::chrono::seconds(5);
+  while(pair.a.Status() == ConnectionStatus_t::CONNECTED_OK && Clock_t::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  CHECK(pair.a.Status() == ConnectionStatus_t::CONNECTION_LOST);
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  DeliveryUnderFaults();
+  ReconnectOneSide();
+  SilentPeerIsLost();
+  return test::Result("ReliableLinkTest");
+}
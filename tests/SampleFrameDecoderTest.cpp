@@ -0,0 +1,117 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  SampleFrameDecoder: SSE2 kernels give the same samples as scalar ones, Feed() of chunks cut at any byte
+  and wrapping around the rings matches scalar decoding of the whole stream
+*/
+
+#include <string>
+#include <vector>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+
+using namespace board_connect;
+
+
+std::vector<unsigned char> RandomBytes(std::size_t size, unsigned seed) {
+  std::vector<unsigned char> bytes(size);
+  for(auto& byte : bytes) {
+    seed = seed * 1103515245u + 12345u;
+    byte = static_cast<unsigned char>(seed >> 16);
+  }
+  return bytes;
+}
+
+
+  //sizes around vector width and unaligned source
+void KernelsMatchScalar() {
+  const auto bytes = RandomBytes(3 * 64 + 1, 1);
+  for(std::size_t count = 0; count <= 64; ++count) {
+    std::vector<float> simd(count), scalar(count);
+    kernels::Int16ToFloat(bytes.data() + 1, simd.data(), count, 1.0f / 32768);
+    kernels::Int16ToFloatScalar(bytes.data() + 1, scalar.data(), count, 1.0f / 32768);
+    CHECK(simd == scalar);
+    kernels::Int24ToFloat(bytes.data() + 1, simd.data(), count, 1.0f / 8388608);
+    kernels::Int24ToFloatScalar(bytes.data() + 1, scalar.data(), count, 1.0f / 8388608);
+    CHECK(simd == scalar);
+  }
+    //sign of int24 samples
+  const unsigned char extremes[] = { 0xff, 0xff, 0x7f,  0x00, 0x00, 0x80,  0xff, 0xff, 0xff,  0x01, 0x00, 0x00 };
+  float converted[4];
+  kernels::Int24ToFloat(extremes, converted, 4, 1.0f);
+  CHECK(converted[0] == 8388607.0f);
+  CHECK(converted[1] == -8388608.0f);
+  CHECK(converted[2] == -1.0f);
+  CHECK(converted[3] == 1.0f);
+
+  std::vector<float> interleaved(9 * 13);
+  for(std::size_t i = 0; i < interleaved.size(); ++i) {
+    interleaved[i] = static_cast<float>(i);
+  }
+  for(std::size_t channels_count = 1; channels_count <= 9; ++channels_count) {
+    for(std::size_t frames_count = 0; frames_count <= 13; ++frames_count) {
+      const std::size_t stride = frames_count + 3;
+      std::vector<float> simd(channels_count * stride, -1.0f), scalar(channels_count * stride, -1.0f);
+      kernels::Deinterleave(interleaved.data(), channels_count, frames_count, simd.data(), stride);
+      kernels::DeinterleaveScalar(interleaved.data(), channels_count, frames_count, scalar.data(), stride);
+      CHECK(simd == scalar);
+    }
+  }
+}
+
+
+  //capacity is not a multiple of 4, so runs of SSE2 blocks end at the middle of the ring
+void FeedMatchesScalar(std::size_t channels_count, SampleFormat_t format) {
+  constexpr std::size_t CAPACITY = 37;
+  constexpr std::size_t FRAMES_COUNT = 200;
+  const std::size_t sample_size = static_cast<std::size_t>(format);
+  const std::size_t frame_size = channels_count * sample_size;
+  const auto stream = RandomBytes(FRAMES_COUNT * frame_size, static_cast<unsigned>(channels_count * 7 + sample_size));
+  const float scale = 1.0f / 1024;
+
+  std::vector<float> samples(FRAMES_COUNT * channels_count);
+  if(format == SampleFormat_t::INT16_LE)
+    kernels::Int16ToFloatScalar(stream.data(), samples.data(), samples.size(), scale);
+  else
+    kernels::Int24ToFloatScalar(stream.data(), samples.data(), samples.size(), scale);
+
+  SampleFrameDecoder decoder(channels_count, format, CAPACITY, scale);
+  std::vector<float> channel(CAPACITY);
+  for(std::size_t position = 0, length = 1; position < stream.size(); position += length, length = length % 29 + 1) {
+    length = std::min(length, stream.size() - position);
+    decoder.Feed(reinterpret_cast<const char*>(stream.data()) + position, length);
+
+    const std::size_t frames_fed = (position + length) / frame_size;
+    const std::size_t available = decoder.Available();
+    CHECK(available == std::min(frames_fed, CAPACITY));
+    for(std::size_t ch = 0; ch < channels_count; ++ch) {
+      CHECK(decoder.Read(ch, channel.data(), CAPACITY) == available);
+      bool same = true;
+      for(std::size_t i = 0; i < available; ++i) {
+        same = same && channel[i] == samples[(frames_fed - available + i) * channels_count + ch];
+      }
+      CHECK(same);
+    }
+  }
+
+    //block longer than rings: only the newest frames are kept
+  SampleFrameDecoder whole(channels_count, format, CAPACITY, scale);
+  whole.Feed(reinterpret_cast<const char*>(stream.data()), stream.size());
+  CHECK(whole.Available() == CAPACITY);
+  CHECK(whole.Read(channels_count - 1, channel.data(), CAPACITY) == CAPACITY);
+  CHECK(channel[CAPACITY - 1] == samples.back());
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  KernelsMatchScalar();
+  for(std::size_t channels_count : { 1, 2, 3, 4, 8 }) {
+    FeedMatchesScalar(channels_count, SampleFormat_t::INT16_LE);
+    FeedMatchesScalar(channels_count, SampleFormat_t::INT24_LE);
+  }
+  return test::Result("SampleFrameDecoderTest");
+}
@@ -0,0 +1,53 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Serial port discovery: serial number from instance id, FindSerialPort by port name, instance id or serial number
+*/
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+
+using namespace board_connect;
+using namespace board_connect::uart;
+
+
+void SerialNumberFromInstanceId() {
+  const SerialPortInfo ftdi = SerialPortInfoFromIds("COM27", "USB\\VID_0403&PID_6001\\A600XYZ");
+  CHECK(ftdi.serial_number == "A600XYZ");
+  CHECK(ftdi.Key() == "USB\\VID_0403&PID_6001\\A600XYZ");
+
+    //id generated by Windows for device without serial number
+  const SerialPortInfo generated = SerialPortInfoFromIds("COM28", "USB\\VID_1A86&PID_7523\\5&2C3F1A&0&2");
+  CHECK(generated.serial_number.empty());
+
+  const SerialPortInfo builtin = SerialPortInfoFromIds("COM1", "ACPI\\PNP0501\\0");
+  CHECK(builtin.serial_number.empty());
+
+  const SerialPortInfo unknown = SerialPortInfoFromIds("COM3", "");
+  CHECK(unknown.Key() == "COM3");
+}
+
+
+void FindByAnyIdentifier() {
+  const std::vector<SerialPortInfo> ports = {
+    SerialPortInfoFromIds("COM1", "ACPI\\PNP0501\\0"),
+    SerialPortInfoFromIds("COM27", "USB\\VID_0403&PID_6001\\A600XYZ"),
+    SerialPortInfoFromIds("COM28", "USB\\VID_1A86&PID_7523\\5&2C3F1A&0&2"),
+  };
+  CHECK(FindSerialPort(ports, "COM27") == ports[1]);
+  CHECK(FindSerialPort(ports, "A600XYZ") == ports[1]);
+  CHECK(FindSerialPort(ports, "USB\\VID_1A86&PID_7523\\5&2C3F1A&0&2") == ports[2]);
+  CHECK(FindSerialPort(ports, "COM2") == std::nullopt);
+  CHECK(FindSerialPort(ports, "A600") == std::nullopt);         //no partial matches
+  CHECK(FindSerialPort(ports, "") == std::nullopt);             //empty serial number of other ports does not match
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  SerialNumberFromInstanceId();
+  FindByAnyIdentifier();
+  return test::Result("SerialPortDiscoveryTest");
+}
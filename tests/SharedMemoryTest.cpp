@@ -0,0 +1,109 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  PublishingBoardConnector and SharedMemoryBoardConnector over in-memory board
+*/
+
+#include <string>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+#include "FakeBoardConnector.h"
+
+using namespace board_connect;
+
+
+std::optional<std::string> ReceiveWithTimeout(Board<std::string>& board, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  const auto deadline = Clock_t::now() + timeout;
+  while(Clock_t::now() < deadline) {
+    auto rx_data = board.Receive();
+    if(rx_data)
+      return rx_data;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return std::nullopt;
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Parcels received by owner of the board are read by another board from the ring,
+      oversized parcel is counted on both sides instead of being lost silently
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void ReaderGetsPublishedParcels() {
+  test::FakeConnectionSettings fake_settings;
+  test::FakeBoardConnectorFactory<std::string> fake_factory;
+  shared_memory::PublishingConnectionSettings publishing_settings("BoardConnectTest_PublishingRing");
+  publishing_settings.slot_count = 16;
+  publishing_settings.slot_size = 8;
+
+  Board<std::string> owner(publishing_settings, shared_memory::PublishingBoardConnectorFactory<std::string>(fake_settings, fake_factory));
+  CHECK(owner.Connect() == ConnectionStatus_t::CONNECTED_OK);
+
+  shared_memory::SharedMemoryConnectionSettings reader_settings("BoardConnectTest_PublishingRing");
+  shared_memory::SharedMemoryBoardConnector<std::string> reader(reader_settings);
+  CHECK(reader.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(!reader.Send(std::string("read-only")));
+
+  CHECK(owner.Send(std::string("first")));
+  CHECK(ReceiveWithTimeout(owner) == std::string("first"));
+  CHECK(reader.Receive() == std::string("first"));
+
+  CHECK(owner.Send(std::string("longer than slot")));
+  CHECK(ReceiveWithTimeout(owner) == std::string("longer than slot"));
+  CHECK(reader.Receive() == std::nullopt);
+  CHECK(reader.DroppedCount() == 1);
+
+    //ring survives reconnection of the board
+  CHECK(owner.Disconnect() == ConnectionStatus_t::DISCONNECTED_OK);
+  CHECK(owner.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  CHECK(owner.Send(std::string("second")));
+  CHECK(ReceiveWithTimeout(owner) == std::string("second"));
+  CHECK(reader.Receive() == std::string("second"));
+  CHECK(reader.LostCount() == 0);
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Parcels are published as they are received, owner of the board never calls Receive()
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void PublishedWithoutOwnerReceive() {
+  test::FakeConnectionSettings fake_settings;
+  test::FakeBoardConnectorFactory<std::string> fake_factory;
+  shared_memory::PublishingConnectionSettings publishing_settings("BoardConnectTest_UnreadRing");
+  publishing_settings.slot_count = 16;
+
+  Board<std::string> owner(publishing_settings, shared_memory::PublishingBoardConnectorFactory<std::string>(fake_settings, fake_factory));
+  CHECK(owner.Connect() == ConnectionStatus_t::CONNECTED_OK);
+
+  shared_memory::SharedMemoryConnectionSettings reader_settings("BoardConnectTest_UnreadRing");
+  shared_memory::SharedMemoryBoardConnector<std::string> reader(reader_settings);
+  CHECK(reader.Connect() == ConnectionStatus_t::CONNECTED_OK);
+
+  const std::string sent[] = { "one", "two", "three" };
+  for(const auto& parcel : sent) {
+    CHECK(owner.Send(parcel));
+  }
+  for(const auto& parcel : sent) {
+    std::optional<std::string> rx_data;
+    const auto deadline = Clock_t::now() + std::chrono::seconds(5);
+    while(!rx_data && Clock_t::now() < deadline) {
+      rx_data = reader.Receive();
+      if(!rx_data)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(rx_data == parcel);
+  }
+  CHECK(reader.LostCount() == 0);
+}
+
+
+int main() {
+  cout.setstate(std::ios::failbit);
+  ReaderGetsPublishedParcels();
+  PublishedWithoutOwnerReceive();
+  return test::Result("SharedMemoryTest");
+}
@@ -0,0 +1,119 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Soak runner: boards echo parcels for a long time, every report period throughput and memory are printed.
+  Throughput drift is relative to the first period, memory growth - to the first report.
+  Usage: SoakRunner [duration_s] [report_period_s] [max_memory_growth_kb]
+  Returns non-zero if memory has grown more than max_memory_growth_kb (no limit by default)
+*/
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+#include "FakeBoardConnector.h"
+
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace board_connect;
+
+
+  //resident set size of the process, kB
+long ResidentMemoryKb() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters{};
+  if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return static_cast<long>(counters.WorkingSetSize / 1024);
+#else
+  long pages_total = 0;
+  long pages_resident = 0;
+  std::FILE* statm = std::fopen("/proc/self/statm", "r");
+  if(!statm)
+    return 0;
+  if(std::fscanf(statm, "%ld %ld", &pages_total, &pages_resident) != 2)
+    pages_resident = 0;
+  std::fclose(statm);
+  return pages_resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+
+int main(int argc, char* argv[]) {
+  cout.setstate(std::ios::failbit);
+  const int duration_s = argc > 1 ? std::atoi(argv[1]) : 60;
+  const int period_s = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+  const long max_growth_kb = argc > 3 ? std::atol(argv[3]) : -1;
+
+  constexpr int BOARDS_COUNT = 4;
+  constexpr long MAX_IN_FLIGHT = 256;       //per board, so queues do not grow because of slow consumer
+  test::FakeConnectionSettings settings;
+  std::vector<Board<std::string>> boards;
+  for(int i = 0; i < BOARDS_COUNT; ++i) {
+    boards.emplace_back(settings, test::FakeBoardConnectorFactory<std::string>());
+    CHECK(boards.back().Connect() == ConnectionStatus_t::CONNECTED_OK);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<long> echoed{0};
+  std::vector<std::thread> threads;
+  for(auto& board : boards) {
+    threads.emplace_back([&stop, &echoed, &board]{
+      long in_flight = 0;
+      std::string payload(64, 'x');
+      while(!stop) {
+        if(in_flight < MAX_IN_FLIGHT && board.Send(payload))
+          ++in_flight;
+        while(board.Receive()) {
+          --in_flight;
+          ++echoed;
+        }
+      }
+    });
+  }
+
+  std::cerr<<"period   parcels/s   drift,%   memory,kB   growth,kB"<<std::endl;
+  double first_rate = 0;
+  long first_memory = 0;
+  long max_growth = 0;
+  long previous_echoed = 0;
+  for(int period = 1; period * period_s <= duration_s; ++period) {
+    std::this_thread::sleep_for(std::chrono::seconds(period_s));
+    const long now_echoed = echoed.load();
+    const double rate = static_cast<double>(now_echoed - previous_echoed) / period_s;
+    previous_echoed = now_echoed;
+    const long memory = ResidentMemoryKb();
+    if(period == 1) {
+      first_rate = rate;
+      first_memory = memory;
+    }
+    const double drift = first_rate > 0 ? (rate - first_rate) * 100.0 / first_rate : 0;
+    max_growth = std::max(max_growth, memory - first_memory);
+    std::cerr<<std::setw(6)<<period<<std::setw(12)<<static_cast<long>(rate)<<std::setw(10)<<std::fixed<<std::setprecision(1)<<drift
+             <<std::setw(12)<<memory<<std::setw(12)<<(memory - first_memory)<<std::endl;
+  }
+
+  stop = true;
+  for(auto& th : threads) {
+    th.join();
+  }
+  for(auto& board : boards) {
+    board.Disconnect();
+  }
+
+  CHECK(echoed > 0);
+  if(max_growth_kb >= 0) {
+    CHECK(max_growth <= max_growth_kb);
+  }
+  return test::Result("SoakRunner");
+}
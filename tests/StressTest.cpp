@@ -0,0 +1,152 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  Stress test: Send / Receive / Connect / Disconnect called concurrently on one board, and concurrent
+  producers of Buffer. Meant to be run under ThreadSanitizer
+  (-DBOARD_CONNECT_SANITIZE=thread on Linux or macOS: it needs no WinApi).
+  Usage: StressTest [duration_ms]
+*/
+
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "BoardConnect.h"
+#include "TestCheck.h"
+#include "FakeBoardConnector.h"
+
+using namespace board_connect;
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Board is hammered by senders, receivers and connect / disconnect cycles at once
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void BoardLifecycleStress(std::chrono::milliseconds duration) {
+  test::FakeConnectionSettings settings;
+  Board<std::string> board(settings, test::FakeBoardConnectorFactory<std::string>());
+  board.Connect();
+
+  std::atomic<bool> stop{false};
+  std::atomic<long> sent{0};
+  std::atomic<long> received{0};
+  std::vector<std::thread> threads;
+
+  for(int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i]{
+      while(!stop) {
+        if(board.Send(std::string("parcel from sender ") + std::to_string(i)))
+          ++sent;
+      }
+    });
+  }
+  threads.emplace_back([&]{
+    while(!stop) {
+      if(board.Receive())
+        ++received;
+    }
+  });
+  threads.emplace_back([&]{
+    while(!stop) {
+      if(board.ReceiveTimestamped())
+        ++received;
+    }
+  });
+  for(int i = 0; i < 2; ++i) {
+    threads.emplace_back([&]{
+      while(!stop) {
+        board.Connect();
+        board.Status();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        board.Disconnect();
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for(auto& th : threads) {
+    th.join();
+  }
+  std::cerr<<"lifecycle: sent "<<sent<<", received "<<received<<std::endl;
+  CHECK(sent > 0);
+  CHECK(received <= sent);
+  CHECK(board.Status() == ConnectionStatus_t::DISCONNECTED_OK);
+
+    //board is usable after the storm: everything sent while connected comes back.
+    //Parcels left in send queue by the storm are sent after reconnection, they are drained first
+  CHECK(board.Connect() == ConnectionStatus_t::CONNECTED_OK);
+  auto last_parcel_time = Clock_t::now();
+  while(Clock_t::now() - last_parcel_time < std::chrono::milliseconds(100)) {
+    if(board.Receive())
+      last_parcel_time = Clock_t::now();
+  }
+  constexpr int PARCELS_COUNT = 1000;
+  for(int i = 0; i < PARCELS_COUNT; ++i) {
+    CHECK(board.Send(std::to_string(i)));
+  }
+  int echoed = 0;
+  const auto deadline = Clock_t::now() + std::chrono::seconds(10);
+  while(echoed < PARCELS_COUNT && Clock_t::now() < deadline) {
+    auto rx_data = board.Receive();
+    if(!rx_data) {
+      std::this_thread::yield();
+      continue;
+    }
+    CHECK(*rx_data == std::to_string(echoed));
+    ++echoed;
+  }
+  CHECK(echoed == PARCELS_COUNT);
+  board.Disconnect();
+}
+
+
+/*  --------------------------------------------------------------------------------------------------------------------
+      Buffer: several producers, one consumer with Load() / ConfirmReception(), order of each producer is kept
+    --------------------------------------------------------------------------------------------------------------------
+*/
+void BufferStress() {
+  constexpr int PRODUCERS_COUNT = 4;
+  constexpr int PARCELS_PER_PRODUCER = 50000;
+
+  Buffer<std::pair<int, int>> buffer;
+  std::vector<std::thread> threads;
+  for(int producer = 0; producer < PRODUCERS_COUNT; ++producer) {
+    threads.emplace_back([&buffer, producer]{
+      for(int i = 0; i < PARCELS_PER_PRODUCER; ++i) {
+        buffer.Store(std::make_pair(producer, i));
+      }
+    });
+  }
+
+  std::vector<int> next_expected(PRODUCERS_COUNT, 0);
+  int consumed = 0;
+  bool ordered = true;
+  while(consumed < PRODUCERS_COUNT * PARCELS_PER_PRODUCER) {
+    std::optional<std::pair<int, int>> item = (consumed % 2) ? buffer.Take() : buffer.Load();
+    if(!item)
+      continue;
+    if(!(consumed % 2))
+      buffer.ConfirmReception();
+    ordered &= (item->second == next_expected[item->first]);
+    next_expected[item->first] = item->second + 1;
+    ++consumed;
+  }
+  for(auto& th : threads) {
+    th.join();
+  }
+  CHECK(ordered);
+  CHECK(!buffer.Load());
+}
+
+
+int main(int argc, char* argv[]) {
+  cout.setstate(std::ios::failbit);      //library reports state changes to cout
+  const std::chrono::milliseconds duration(argc > 1 ? std::atoi(argv[1]) : 2000);
+
+  BoardLifecycleStress(duration);
+  BufferStress();
+  return test::Result("StressTest");
+}
@@ -0,0 +1,43 @@
+/*
+  Board_connection_library
+  by Sergei Grigorev
+  2024
+
+  TestCheck header
+  Minimal checks for test executables: failed check is reported, test returns non-zero exit code
+*/
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+#include <atomic>
+
+namespace board_connect {
+
+namespace test {
+
+inline std::atomic<int>& FailedChecks() {
+  static std::atomic<int> failed{0};
+  return failed;
+}
+
+inline int Result(const char* test_name) {
+  const int failed = FailedChecks().load();
+  std::cerr<<test_name<<(failed == 0 ? ": OK" : ": FAILED")<<" ("<<failed<<" failed checks)"<<std::endl;
+  return failed == 0 ? 0 : 1;
+}
+
+}  //test
+
+}  //board_connect
+
+#define CHECK(condition)                                                                          \
+  do {                                                                                            \
+    if(!(condition)) {                                                                            \
+      ++board_connect::test::FailedChecks();                                                      \
+      std::cerr<<__FILE__<<":"<<__LINE__<<": check failed: "<<#condition<<std::endl;              \
+    }                                                                                             \
+  } while(false)
+
+#endif  //TEST_CHECK_H